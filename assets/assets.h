@@ -26,4 +26,8 @@
 extern const unsigned char ChivoMono_Regular_ttf[];
 extern const unsigned ChivoMono_Regular_ttf_size;
 
+// baked by FontBaker, see atlas.hpp
+extern const unsigned char ChivoMono_Regular_atlas[];
+extern const unsigned ChivoMono_Regular_atlas_size;
+
 #endif //NIHILO_ASSETS_H
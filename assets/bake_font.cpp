@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Bakes the glyph atlas of a font into a C source file, so the application does not rasterize it at startup.
+// Usage: FontBaker <font file> <output C file> <symbol name>
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "atlas.hpp"
+
+void bake(const char* fontPath, const char* outputPath, const std::string& symbol) {
+    std::ifstream input(fontPath, std::ios::binary);
+    if (!input) {
+        throw std::runtime_error(std::string("Failed to open ") + fontPath);
+    }
+    const std::vector<unsigned char> font((std::istreambuf_iterator(input)), std::istreambuf_iterator<char>());
+
+    const std::vector<unsigned char> data = writeAtlas(createAtlas(font.data(), font.size()));
+
+    std::ofstream output(outputPath);
+    if (!output) {
+        throw std::runtime_error(std::string("Failed to open ") + outputPath);
+    }
+
+    static constexpr char HEX[] = "0123456789abcdef";
+    output << "const unsigned char " << symbol << "[] = {";
+    for (size_t i = 0; i < data.size(); i++) {
+        if (i % 16 == 0) {
+            output << '\n';
+        }
+        output << "0x" << HEX[data[i] >> 4] << HEX[data[i] & 0xF] << ',';
+    }
+    output << "\n};\nconst unsigned " << symbol << "_size = sizeof(" << symbol << ");\n";
+}
+
+int main(const int argc, char** argv) {
+    if (argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <font file> <output C file> <symbol name>\n";
+        return -1;
+    }
+
+    try {
+        bake(argv[1], argv[2], argv[3]);
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return -1;
+    }
+}
@@ -45,5 +45,6 @@ class Box {
 };
 
 typedef Box<2, float, glm::defaultp> Box2;
+typedef Box<3, float, glm::defaultp> Box3;
 
 #endif //NIHILO_BOX_HPP
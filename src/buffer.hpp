@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_BUFFER_HPP
+#define NIHILO_BUFFER_HPP
+
+#include <atomic>
+
+/**
+ * Lock-free single producer single consumer channel always giving the consumer the latest complete value.
+ *
+ * Three values are preallocated and reused: the producer fills the back one, the consumer reads the front one
+ * and the middle one holds the latest published value. Publishing and consuming only swap indices,
+ * so neither side ever blocks, waits for the other or allocates.
+ *
+ * Since values are reused, the producer must overwrite every field it publishes.
+ */
+template<typename T>
+class TripleBuffer {
+    public:
+
+    /**
+     * Gives access to any of the three values, for instance to attach resources to them.
+     * Only safe before the producer and the consumer start.
+     *
+     * @param index The value index, from 0 to 2.
+     * @return The value.
+     */
+    T& get(const unsigned int index) {
+        return _values[index];
+    }
+
+    /**
+     * Producer side.
+     *
+     * @return The value to fill before publishing it.
+     */
+    T& write() {
+        return _values[_back];
+    }
+
+    /**
+     * Producer side.
+     * Publishes the written value, replacing any previously published value that was not consumed yet.
+     */
+    void publish() {
+        _back = _middle.exchange(_back | DIRTY, std::memory_order_acq_rel) & INDEX;
+    }
+
+    /**
+     * Consumer side.
+     * Takes the latest published value, if any.
+     *
+     * @return Whether a new value was taken.
+     */
+    bool update() {
+        if (!hasUpdate()) {
+            return false;
+        }
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & INDEX;
+        _received = true;
+        return true;
+    }
+
+    /**
+     * Consumer side.
+     *
+     * @return Whether a value was published since the last update.
+     */
+    [[nodiscard]] bool hasUpdate() const {
+        return _middle.load(std::memory_order_acquire) & DIRTY;
+    }
+
+    /**
+     * Consumer side.
+     *
+     * @return The latest value taken, only valid if not empty.
+     */
+    [[nodiscard]] const T& read() const {
+        return _values[_front];
+    }
+
+    /**
+     * Consumer side.
+     * The consumer owns the value until the next update and may change it before handing it back.
+     *
+     * @return The latest value taken, only valid if not empty.
+     */
+    [[nodiscard]] T& read() {
+        return _values[_front];
+    }
+
+    /**
+     * Consumer side.
+     *
+     * @return Whether no value was taken yet.
+     */
+    [[nodiscard]] bool isEmpty() const {
+        return !_received;
+    }
+
+    private:
+
+    static constexpr unsigned int INDEX = 3, DIRTY = 4;
+
+    T _values[3]{};
+    unsigned int _back = 0, _front = 2;
+    bool _received = false;
+    std::atomic<unsigned int> _middle = 1;
+};
+
+#endif //NIHILO_BUFFER_HPP
@@ -28,6 +28,8 @@
 struct CameraSnapshot {
     float fov;
     glm::vec3 position, forward, up;
+
+    bool operator==(const CameraSnapshot&) const = default;
 };
 
 /**
@@ -35,8 +37,22 @@ struct CameraSnapshot {
  */
 struct ControlSnapshot : CameraSnapshot {
     int width, height;
-    bool debug, help;
+    bool debug, help, instanced, sprites, culling, gpuCulling, density, smooth, trails;
     float speed;
+
+    bool operator==(const ControlSnapshot&) const = default;
+};
+
+/**
+ * Simulation settings chosen by the user, applied to the simulator by the control thread.
+ */
+struct SimulationControl {
+    bool multiRate;
+    unsigned int substeps;
+    unsigned int potentials; // index of the potential preset, wrapped by the simulation
+    bool hierarchical, regularized;
+
+    bool operator==(const SimulationControl&) const = default;
 };
 
 #endif //NIHILO_CONTROL_HPP
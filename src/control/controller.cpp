@@ -74,6 +74,43 @@ void Controller::keyPressed(const int key, const char ch) {
                 case 'h':
                     _help = !_help;
                     break;
+                case 'i':
+                    _instanced = !_instanced;
+                    break;
+                case 'p':
+                    _sprites = !_sprites;
+                    break;
+                case 'f':
+                    _culling = !_culling;
+                    break;
+                case 'g':
+                    _gpuCulling = !_gpuCulling;
+                    break;
+                case 'a':
+                    _density = !_density;
+                    break;
+                case 'm':
+                    _smooth = !_smooth;
+                    break;
+                case 't':
+                    _trails = !_trails;
+                    break;
+                case 'r':
+                    _multiRate = !_multiRate;
+                    break;
+                case 'n':
+                    // cycles through powers of two
+                    _substeps = _substeps < MAX_SUBSTEPS ? _substeps * 2 : 1;
+                    break;
+                case 'o':
+                    _potentials++;
+                    break;
+                case 'y':
+                    _hierarchical = !_hierarchical;
+                    break;
+                case 'k':
+                    _regularized = !_regularized;
+                    break;
                 case 'c':
                     _right = true;
                     break;
@@ -216,9 +253,24 @@ void Controller::snapshot(ControlSnapshot& snapshot) const {
     _camera.snapshot(snapshot);
     snapshot.debug = _debug;
     snapshot.help = _help;
+    snapshot.instanced = _instanced;
+    snapshot.sprites = _sprites;
+    snapshot.culling = _culling;
+    snapshot.gpuCulling = _gpuCulling;
+    snapshot.density = _density;
+    snapshot.smooth = _smooth;
+    snapshot.trails = _trails;
     snapshot.speed = _speed;
 }
 
+void Controller::snapshot(SimulationControl& snapshot) const {
+    snapshot.multiRate = _multiRate;
+    snapshot.substeps = _substeps;
+    snapshot.potentials = _potentials;
+    snapshot.hierarchical = _hierarchical;
+    snapshot.regularized = _regularized;
+}
+
 float Controller::getZoomFactor() const {
     return _camera.getFOV() / DEFAULT_FOV;
 }
@@ -26,6 +26,8 @@
 #include "camera.hpp"
 #include "control.hpp"
 
+constexpr unsigned int DEFAULT_SUBSTEPS = 4, MAX_SUBSTEPS = 16; // near field substeps of the multi-rate integrator
+
 class Controller {
     public:
 
@@ -45,14 +47,20 @@ class Controller {
 
     void snapshot(ControlSnapshot& snapshot) const;
 
+    void snapshot(SimulationControl& snapshot) const;
+
     private:
 
     [[nodiscard]] float getZoomFactor() const;
 
     Camera _camera;
-    bool _debug{}, _help{true};
+    bool _debug{}, _help{true}, _instanced{true}, _sprites{true}, _culling{true}, _gpuCulling{}, _density{}, _smooth{}, _trails{};
     bool _zoomIn{}, _zoomOut{}, _left{}, _right{}, _forward{}, _backward{}, _up{}, _down{}, _speedUp{}, _slowDown{};
     float _speed{1};
+    bool _multiRate{};
+    unsigned int _substeps{DEFAULT_SUBSTEPS};
+    unsigned int _potentials{};
+    bool _hierarchical{}, _regularized{};
     bool _mouseDragging;
     glm::vec2 _previousMousePosition;
 };
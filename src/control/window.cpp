@@ -166,6 +166,19 @@ void Window::update() const {
     glfwSwapBuffers(_window);
 }
 
+int Window::getRefreshRate() const {
+    GLFWmonitor* monitor = glfwGetWindowMonitor(_window);
+    if (!monitor) {
+        monitor = glfwGetPrimaryMonitor();
+    }
+    if (monitor) {
+        if (const GLFWvidmode* mode = glfwGetVideoMode(monitor); mode && mode->refreshRate > 0) {
+            return mode->refreshRate;
+        }
+    }
+    return 60;
+}
+
 void Window::getSize(int& width, int& height) const {
     glfwGetFramebufferSize(_window, &width, &height);
 }
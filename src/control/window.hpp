@@ -45,6 +45,8 @@ class Window {
 
     void getSize(int& width, int& height) const;
 
+    [[nodiscard]] int getRefreshRate() const;
+
     private:
 
     Controller& _controller;
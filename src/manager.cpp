@@ -22,20 +22,34 @@
 
 #include "manager.hpp"
 
+#include <chrono>
 #include <thread>
 
+#include "simulation/preset.hpp"
+
+constexpr bool MAPPED_SNAPSHOTS = true; // whether the simulation writes positions directly into GPU memory
+
 Manager::Manager() :
 _window(_controller),
 _controlLoop([this] { updateControls(); }),
 _simulationLoop([this] { updateSimulation(); }),
 _renderLoop([this] { updateRender(); }),
-_controlSnapshot(),
-_simulationSnapshot() {
+_simulationChanged(false), _publishedControl(), _simulationControl(), _damage(0) {
     _window.center();
+
+    if (MAPPED_SNAPSHOTS) {
+        for (unsigned int i = 0; i < 3; i++) {
+            _renderer.attachMapping(_simulationSnapshot.get(i), Renderer::MAPPED_CAPACITY);
+        }
+    }
+
+    _controller.snapshot(_simulationControl);
+    applySimulationControl();
+
     Window::clearContext(); // we will transfer gl context to the render thread
 
     _controlLoop.setTargetFrequency(60);
-    _renderLoop.setTargetFrequency(60);
+    _renderLoop.setTargetFrequency(_window.getRefreshRate()); // interpolation keeps motion smooth at any rate
     _simulationLoop.setTargetFrequency(60);
 }
 
@@ -63,6 +77,10 @@ void Manager::stop() {
     _controlLoop.stop();
     _renderLoop.stop();
     _simulationLoop.stop();
+
+    // wake up the render thread if it is waiting for changes
+    _damage.fetch_add(1, std::memory_order_release);
+    _damage.notify_all();
 }
 
 void Manager::updateControls() {
@@ -70,44 +88,80 @@ void Manager::updateControls() {
 
     _controller.update();
 
-    const auto snapshot = std::make_shared<ControlSnapshot>();
-    _controller.snapshot(*snapshot);
-    _window.getSize(snapshot->width, snapshot->height);
-    _controlSnapshot = snapshot;
+    ControlSnapshot& snapshot = _controlSnapshot.write();
+    _controller.snapshot(snapshot);
+    _window.getSize(snapshot.width, snapshot.height);
+
+    // unchanged controls are not published so that the render thread can stay idle
+    if (snapshot != _publishedControl) {
+        _publishedControl = snapshot;
+        _controlSnapshot.publish();
+        _damage.fetch_add(1, std::memory_order_release);
+        _damage.notify_one();
+    }
+
+    // simulator settings are atomic and picked up at its next update
+    SimulationControl simulationControl{};
+    _controller.snapshot(simulationControl);
+    if (simulationControl != _simulationControl) {
+        _simulationControl = simulationControl;
+        applySimulationControl();
+    }
 
     if (_window.shouldClose()) {
         stop();
     }
 }
 
+void Manager::applySimulationControl() {
+    _simulator.setIntegrator(_simulationControl.multiRate ? Integrator::MULTI_RATE : Integrator::VERLET);
+    _simulator.setSubsteps(_simulationControl.substeps);
+    _simulator.setPotentials(solarSystemPotentials(_simulationControl.potentials));
+    _simulator.setHierarchical(_simulationControl.hierarchical);
+    _simulator.setRegularized(_simulationControl.regularized);
+}
+
 void Manager::updateSimulation() {
     _simulator.update();
 
-    const auto snapshot = std::make_shared<SimulationSnapshot>();
-    _simulator.snapshot(*snapshot);
-    _simulationSnapshot = snapshot;
+    SimulationSnapshot& snapshot = _simulationSnapshot.write();
+    _simulator.snapshot(snapshot);
+    snapshot.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    _simulationSnapshot.publish();
+    _damage.fetch_add(1, std::memory_order_release);
+    _damage.notify_one();
 }
 
 void Manager::updateRender() {
-    const std::shared_ptr<SimulationSnapshot> simulationSnapshot = _simulationSnapshot;
-    if (simulationSnapshot == nullptr) {
-        return;
+    // read before looking for changes so that a publication in between is not missed
+    const unsigned int damage = _damage.load(std::memory_order_acquire);
+    if (_simulationSnapshot.hasUpdate()) {
+        // the current snapshot goes back to the simulation which may overwrite its mapping right away
+        if (!_simulationSnapshot.isEmpty()) {
+            _renderer.retire(_simulationSnapshot.read());
+        }
+        _simulationSnapshot.update();
+        _simulationChanged = true;
     }
+    const bool controlChanged = _controlSnapshot.update();
 
-    const std::shared_ptr<ControlSnapshot> controlSnapshot = _controlSnapshot;
-    if (controlSnapshot == nullptr) {
+    // nothing changed since the last frame: skip it and sleep until something is published
+    if (_simulationSnapshot.isEmpty() || _controlSnapshot.isEmpty()
+        || (!_simulationChanged && !controlChanged && !_controlSnapshot.read().debug && !_renderer.isAnimating())) {
+        _damage.wait(damage, std::memory_order_acquire);
         return;
     }
 
+    const ControlSnapshot& controlSnapshot = _controlSnapshot.read();
+
     ManagerTiming timing;
-    if (controlSnapshot->debug) {
+    if (controlSnapshot.debug) {
         _simulationLoop.getTiming(timing.simulation);
         _renderLoop.getTiming(timing.render);
     }
 
-    const bool changed = simulationSnapshot.get() != _lastSimulationSnapshot.lock().get();
-    _lastSimulationSnapshot = simulationSnapshot;
-    _renderer.render(*controlSnapshot, *simulationSnapshot, changed, timing);
+    _renderer.render(controlSnapshot, _simulationSnapshot.read(), _simulationChanged, timing);
+    _simulationChanged = false;
 
     _window.update();
 }
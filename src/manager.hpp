@@ -23,6 +23,9 @@
 #ifndef NIHILO_MANAGER_HPP
 #define NIHILO_MANAGER_HPP
 
+#include <atomic>
+
+#include "buffer.hpp"
 #include "loop.hpp"
 #include "control/controller.hpp"
 #include "control/window.hpp"
@@ -48,6 +51,8 @@ class Manager {
 
     void updateRender();
 
+    void applySimulationControl();
+
     Controller _controller;
     Window _window;
     Renderer _renderer;
@@ -55,9 +60,12 @@ class Manager {
 
     Loop _controlLoop, _simulationLoop, _renderLoop;
 
-    std::atomic<std::shared_ptr<ControlSnapshot>> _controlSnapshot;
-    std::atomic<std::shared_ptr<SimulationSnapshot>> _simulationSnapshot;
-    std::weak_ptr<SimulationSnapshot> _lastSimulationSnapshot;
+    TripleBuffer<ControlSnapshot> _controlSnapshot;
+    TripleBuffer<SimulationSnapshot> _simulationSnapshot;
+    bool _simulationChanged;
+    ControlSnapshot _publishedControl; // last control snapshot published, only changes are published
+    SimulationControl _simulationControl; // last simulation settings applied, only changes are applied
+    std::atomic<unsigned int> _damage; // incremented on every publication, the render thread waits on it when idle
 };
 
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "atlas.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include "freetype/freetype.h"
+#include "freetype/ftmodapi.h"
+
+constexpr unsigned int GLYPH_PADDING = 1; // keeps linear filtering from sampling the neighbours
+constexpr unsigned int SDF_SPREAD = 4; // pixels of distance around the outline, enough for plain text
+
+// the baked format stores the characters as they are in memory, so the header also checks their layout
+struct AtlasHeader {
+    char magic[4];
+    unsigned int glyphSize, width, height, characterSize;
+};
+
+constexpr char ATLAS_MAGIC[4] = {'N', 'S', 'D', 'F'};
+
+GlyphAtlas createAtlas(const unsigned char* font, const std::size_t size) {
+    FT_Library ft;
+    if (FT_Init_FreeType(&ft)) {
+        throw std::runtime_error("Failed to initialize FreeType");
+    }
+
+    constexpr FT_Int spread = SDF_SPREAD;
+    FT_Property_Set(ft, "sdf", "spread", &spread);
+
+    const FT_Open_Args args{
+        FT_OPEN_MEMORY,
+        font,
+        static_cast<FT_Long>(size),
+        nullptr,
+        nullptr,
+        nullptr,
+        0
+    };
+
+    FT_Face face;
+    if (FT_Open_Face(ft, &args, 0, &face)) {
+        throw std::runtime_error("Failed to load font");
+    }
+
+    FT_Set_Pixel_Sizes(face, GlyphAtlas::GLYPH_SIZE, GlyphAtlas::GLYPH_SIZE);
+
+    GlyphAtlas atlas{};
+    constexpr auto em = static_cast<float>(GlyphAtlas::GLYPH_SIZE);
+
+    struct Bitmap {
+        unsigned char c;
+        unsigned int width, rows;
+        std::vector<unsigned char> pixels;
+    };
+    std::vector<Bitmap> bitmaps;
+
+    // control characters are never displayed, only printable ones take space in the atlas
+    for (unsigned char c = 0; c < 128; c++) {
+        if (FT_Load_Char(face, c, FT_LOAD_DEFAULT)) {
+            throw std::runtime_error("Failed to load character");
+        }
+
+        const auto glyph = face->glyph;
+        Character& character = atlas.chars[c];
+        character.advance = static_cast<float>(glyph->advance.x) / (em * 64);
+
+        // whitespace has no outline to render
+        if (c < 32 || c == 127 || glyph->outline.n_points == 0) {
+            continue;
+        }
+
+        if (FT_Render_Glyph(glyph, FT_RENDER_MODE_SDF)) {
+            throw std::runtime_error("Failed to render character");
+        }
+
+        const FT_Bitmap& bitmap = glyph->bitmap;
+        if (bitmap.width + GLYPH_PADDING > GlyphAtlas::WIDTH) {
+            throw std::runtime_error("Character is larger than the atlas");
+        }
+
+        Bitmap& copy = bitmaps.emplace_back(c, bitmap.width, bitmap.rows);
+        copy.pixels.resize(static_cast<std::size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int row = 0; row < bitmap.rows; row++) {
+            std::memcpy(copy.pixels.data() + static_cast<std::size_t>(row) * bitmap.width, bitmap.buffer + static_cast<std::ptrdiff_t>(row) * bitmap.pitch, bitmap.width);
+        }
+
+        // the distance field spreads outside the outline, the metrics include it
+        character.size = glm::vec2(bitmap.width, bitmap.rows) / em;
+        character.bearing = glm::vec2(glyph->bitmap_left, glyph->bitmap_top) / em;
+    }
+
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
+
+    // shelves waste less space when glyphs of similar height are next to each other
+    std::ranges::sort(bitmaps, std::greater(), &Bitmap::rows);
+
+    unsigned int x = 0, y = 0, shelfHeight = 0;
+    for (const Bitmap& bitmap : bitmaps) {
+        if (x + bitmap.width + GLYPH_PADDING > GlyphAtlas::WIDTH) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        atlas.chars[bitmap.c].uv = glm::vec4(x, y, x + bitmap.width, y + bitmap.rows);
+        x += bitmap.width + GLYPH_PADDING;
+        shelfHeight = std::max(shelfHeight, bitmap.rows + GLYPH_PADDING);
+    }
+
+    atlas.height = y + shelfHeight;
+    atlas.pixels.resize(static_cast<std::size_t>(GlyphAtlas::WIDTH) * atlas.height);
+
+    const glm::vec4 scale(GlyphAtlas::WIDTH, atlas.height, GlyphAtlas::WIDTH, atlas.height);
+    for (const Bitmap& bitmap : bitmaps) {
+        glm::vec4& uv = atlas.chars[bitmap.c].uv;
+        const auto left = static_cast<unsigned int>(uv.x), top = static_cast<unsigned int>(uv.y);
+        for (unsigned int row = 0; row < bitmap.rows; row++) {
+            std::memcpy(atlas.pixels.data() + static_cast<std::size_t>(top + row) * GlyphAtlas::WIDTH + left, bitmap.pixels.data() + static_cast<std::size_t>(row) * bitmap.width, bitmap.width);
+        }
+        uv /= scale;
+    }
+
+    return atlas;
+}
+
+std::vector<unsigned char> writeAtlas(const GlyphAtlas& atlas) {
+    AtlasHeader header{};
+    std::memcpy(header.magic, ATLAS_MAGIC, sizeof(ATLAS_MAGIC));
+    header.glyphSize = GlyphAtlas::GLYPH_SIZE;
+    header.width = GlyphAtlas::WIDTH;
+    header.height = atlas.height;
+    header.characterSize = sizeof(Character);
+
+    std::vector<unsigned char> data(sizeof(AtlasHeader) + sizeof(atlas.chars) + atlas.pixels.size());
+    std::memcpy(data.data(), &header, sizeof(AtlasHeader));
+    std::memcpy(data.data() + sizeof(AtlasHeader), atlas.chars, sizeof(atlas.chars));
+    std::memcpy(data.data() + sizeof(AtlasHeader) + sizeof(atlas.chars), atlas.pixels.data(), atlas.pixels.size());
+    return data;
+}
+
+std::optional<GlyphAtlas> readAtlas(const unsigned char* data, const std::size_t size) {
+    if (size < sizeof(AtlasHeader) + sizeof(GlyphAtlas::chars)) {
+        return std::nullopt;
+    }
+
+    AtlasHeader header;
+    std::memcpy(&header, data, sizeof(AtlasHeader));
+    if (std::memcmp(header.magic, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) != 0 || header.glyphSize != GlyphAtlas::GLYPH_SIZE
+        || header.width != GlyphAtlas::WIDTH || header.characterSize != sizeof(Character)
+        || size != sizeof(AtlasHeader) + sizeof(GlyphAtlas::chars) + static_cast<std::size_t>(header.width) * header.height) {
+        return std::nullopt;
+    }
+
+    GlyphAtlas atlas{};
+    atlas.height = header.height;
+    std::memcpy(atlas.chars, data + sizeof(AtlasHeader), sizeof(atlas.chars));
+    atlas.pixels.assign(data + sizeof(AtlasHeader) + sizeof(atlas.chars), data + size);
+    return atlas;
+}
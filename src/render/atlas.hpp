@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_ATLAS_HPP
+#define NIHILO_ATLAS_HPP
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "glm/glm.hpp"
+
+struct Character {
+    glm::vec2 size;
+    glm::vec2 bearing;
+    float advance;
+    glm::vec4 uv; // left, top, right and bottom in the atlas
+};
+
+/**
+ * Signed distance fields of the ASCII glyphs packed in shelves into a single texture.
+ * The edge of a glyph is at 0.5, higher values are inside.
+ */
+struct GlyphAtlas {
+    static constexpr unsigned int GLYPH_SIZE = 32; // pixels per em
+    static constexpr unsigned int WIDTH = 256;
+
+    unsigned int height;
+    std::vector<unsigned char> pixels;
+    Character chars[128];
+};
+
+/**
+ * Rasterizes and packs the glyphs of a font, without using any GL function.
+ * @param font The font file data
+ * @param size The size of the font file data
+ * @return The atlas, with metrics in em units
+ */
+GlyphAtlas createAtlas(const unsigned char* font, std::size_t size);
+
+/**
+ * Serializes an atlas into the binary format baked at build time.
+ * @param atlas The atlas
+ * @return The bytes of the atlas
+ */
+std::vector<unsigned char> writeAtlas(const GlyphAtlas& atlas);
+
+/**
+ * Reads an atlas baked at build time.
+ * @param data The bytes of the atlas
+ * @param size The number of bytes
+ * @return The atlas, or nothing if the data is missing or was baked with other parameters
+ */
+std::optional<GlyphAtlas> readAtlas(const unsigned char* data, std::size_t size);
+
+#endif //NIHILO_ATLAS_HPP
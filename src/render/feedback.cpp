@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "feedback.hpp"
+
+#include "glad.h"
+
+FeedbackBuffer::FeedbackBuffer() : _id(0), _bufferId(0), _capacity(0) {
+    glGenTransformFeedbacks(1, &_id);
+    glGenBuffers(1, &_bufferId);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, _id);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _bufferId);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+}
+
+FeedbackBuffer::~FeedbackBuffer() {
+    glDeleteTransformFeedbacks(1, &_id);
+    glDeleteBuffers(1, &_bufferId);
+}
+
+void FeedbackBuffer::use() const {
+    glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+}
+
+void FeedbackBuffer::reserve(const unsigned long long size) {
+    if (size <= _capacity) {
+        return;
+    }
+    _capacity = size;
+    glBindBuffer(GL_ARRAY_BUFFER, _bufferId);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<long long>(size), nullptr, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void FeedbackBuffer::begin(const unsigned int mode) const {
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, _id);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(mode);
+}
+
+void FeedbackBuffer::end() {
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+}
+
+void FeedbackBuffer::draw(const unsigned int mode) const {
+    glDrawTransformFeedback(mode, _id);
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_FEEDBACK_HPP
+#define NIHILO_FEEDBACK_HPP
+
+/**
+ * Buffer filled by transform feedback, which can be drawn again without reading back the number of primitives.
+ */
+class FeedbackBuffer {
+
+    public:
+
+    FeedbackBuffer();
+
+    ~FeedbackBuffer();
+
+    FeedbackBuffer(const FeedbackBuffer&) = delete;
+
+    FeedbackBuffer& operator=(const FeedbackBuffer&) = delete;
+
+    void use() const;
+
+    /**
+     * Grows the buffer so it can hold at least the given number of bytes.
+     * @param size The size in bytes
+     */
+    void reserve(unsigned long long size);
+
+    /**
+     * Starts capturing primitives into the buffer, replacing its content.
+     * @param mode The primitive mode, must match the output of the program in use
+     */
+    void begin(unsigned int mode) const;
+
+    static void end();
+
+    /**
+     * Draws the primitives captured by the last capture.
+     * @param mode The primitive mode
+     */
+    void draw(unsigned int mode) const;
+
+    private:
+
+    unsigned int _id, _bufferId;
+    unsigned long long _capacity;
+};
+
+#endif //NIHILO_FEEDBACK_HPP
@@ -23,19 +23,11 @@
 #ifndef NIHILO_FONT_HPP
 #define NIHILO_FONT_HPP
 
-#include <string>
-
-#include "shader.hpp"
-#include "vertex.hpp"
-#include "glm/glm.hpp"
-#include "../box.hpp"
-
-struct Character {
-    glm::vec2 size;
-    glm::vec2 bearing;
-    float advance;
-};
+#include "atlas.hpp"
 
+/**
+ * Glyph atlas texture and metrics of the embedded monospaced font, text is drawn by Hud.
+ */
 class Font {
 
     public:
@@ -44,22 +36,22 @@ class Font {
 
     ~Font();
 
-    Box2 setText(const std::string& text);
+    Font(const Font&) = delete;
+
+    Font& operator=(const Font&) = delete;
 
-    void setColor(const glm::vec3& color) const;
+    [[nodiscard]] const Character& getCharacter(unsigned char c) const;
 
-    void render(const glm::mat4& transformation) const;
+    /**
+     * Binds the glyph atlas to the first texture unit.
+     */
+    void useTexture() const;
 
     private:
 
-    Shader _shader;
-    Uniform _transformation, _color;
-    VertexAttributes _attributes;
-    VertexBuffer _buffer;
     unsigned int _textureId{};
     Character _chars[128]{};
-    unsigned int _glyphs;
 };
 
 
-#endif //NIHILO_FONT_HPP
\ No newline at end of file
+#endif //NIHILO_FONT_HPP
@@ -20,32 +20,42 @@
  * SOFTWARE.
  */
 
-#ifndef NIHILO_RECTANGLE_HPP
-#define NIHILO_RECTANGLE_HPP
+#ifndef NIHILO_FRAMEBUFFER_HPP
+#define NIHILO_FRAMEBUFFER_HPP
 
-#include "shader.hpp"
-#include "vertex.hpp"
-#include "../box.hpp"
-
-class Rectangle {
+/**
+ * Offscreen framebuffer with a single floating point color attachment and no depth.
+ */
+class Framebuffer {
 
     public:
 
-    Rectangle();
+    Framebuffer();
+
+    ~Framebuffer();
+
+    Framebuffer(const Framebuffer&) = delete;
 
-    void setBox(const Box2& box) const;
+    Framebuffer& operator=(const Framebuffer&) = delete;
 
-    void setColor(const glm::vec4& color) const;
+    /**
+     * Resizes the color attachment, its content is lost when the size changes.
+     */
+    void resize(int width, int height);
 
-    void render(const glm::mat4& transformation) const;
+    void use() const;
+
+    static void clearUse();
+
+    /**
+     * Binds the color attachment to the active texture unit.
+     */
+    void useTexture() const;
 
     private:
 
-    Shader _shader;
-    Uniform _transformation, _color;
-    VertexAttributes _attributes;
-    VertexBuffer _buffer;
+    unsigned int _id, _textureId;
+    int _width, _height;
 };
 
-
-#endif //NIHILO_RECTANGLE_HPP
\ No newline at end of file
+#endif //NIHILO_FRAMEBUFFER_HPP
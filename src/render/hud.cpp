@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "hud.hpp"
+
+#include <stdexcept>
+
+#include "glad.h"
+
+// language=glsl
+const std::string hudVertex = R"(
+#version 330 core
+
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 size;
+layout (location = 2) in vec4 uv;
+layout (location = 3) in int character;
+
+flat out vec2 geomSize;
+flat out vec4 geomUv;
+flat out int geomChar;
+
+void main() {
+    gl_Position = vec4(position, 0, 1);
+    geomSize = size;
+    geomUv = uv;
+    geomChar = character;
+}
+)";
+
+// language=glsl
+const std::string hudGeometry = R"(
+#version 330 core
+
+layout (points) in;
+layout (triangle_strip, max_vertices = 4) out;
+
+flat in vec2[] geomSize;
+flat in vec4[] geomUv;
+flat in int[] geomChar;
+
+flat out int character;
+out vec2 texturePos;
+
+uniform mat4 transformation;
+
+void main() {
+    vec2 pos = gl_in[0].gl_Position.xy;
+    vec2 size = geomSize[0];
+    vec4 uv = geomUv[0];
+    character = geomChar[0];
+    texturePos = uv.xy;
+    gl_Position = transformation * vec4(pos + vec2(0, size.y), 0, 1);
+    EmitVertex();
+    character = geomChar[0];
+    texturePos = uv.xw;
+    gl_Position = transformation * vec4(pos, 0, 1);
+    EmitVertex();
+    character = geomChar[0];
+    texturePos = uv.zy;
+    gl_Position = transformation * vec4(pos + size, 0, 1);
+    EmitVertex();
+    character = geomChar[0];
+    texturePos = uv.zw;
+    gl_Position = transformation * vec4(pos + vec2(size.x, 0), 0, 1);
+    EmitVertex();
+    EndPrimitive();
+}
+)";
+
+// language=glsl
+const std::string hudFragment = R"(
+#version 330 core
+
+flat in int character;
+in vec2 texturePos;
+
+out vec4 outColor;
+
+uniform sampler2D atlas;
+uniform vec3 textColor;
+uniform vec4 panelColor;
+
+void main() {
+    if (character == 255) {
+        outColor = panelColor;
+        return;
+    }
+    float distance = texture(atlas, texturePos).r;
+    float width = fwidth(distance);
+    float a = smoothstep(0.5 - width, 0.5 + width, distance);
+    if (a == 0) {
+        discard;
+    }
+    outColor = vec4(textColor, a);
+}
+)";
+
+constexpr unsigned char PANEL = 255;
+constexpr float LINE_HEIGHT = 1.3f;
+
+Hud::Hud(const Font& font) :
+_font(font), _shader(hudVertex, hudGeometry, hudFragment),
+_transformation(_shader.uniform("transformation")), _textColor(_shader.uniform("textColor")), _panelColor(_shader.uniform("panelColor")),
+_glyphs(1), _lines(0), _advance(font.getCharacter('0').advance), _uploaded(false) {
+    _attributes.use();
+    _buffer.use();
+    VertexAttributes::setFloat(0, 2, sizeof(HudGlyph), offsetof(HudGlyph, position));
+    VertexAttributes::setFloat(1, 2, sizeof(HudGlyph), offsetof(HudGlyph, size));
+    VertexAttributes::setFloat(2, 4, sizeof(HudGlyph), offsetof(HudGlyph, uv));
+    VertexAttributes::setByte(3, 1, sizeof(HudGlyph), offsetof(HudGlyph, character));
+    VertexBuffer::clearUse();
+    VertexAttributes::clearUse();
+}
+
+unsigned int Hud::addLine(const std::string_view label, const unsigned int width) {
+    if (width > MAX_FIELD_WIDTH) {
+        throw std::domain_error("Field width must not exceed MAX_FIELD_WIDTH");
+    }
+
+    const unsigned int line = _lines++;
+    unsigned int column = 0;
+    for (const char c : label) {
+        _glyphs.push_back(layout(c, line, column++));
+    }
+
+    _fields.push_back({static_cast<unsigned int>(_glyphs.size()), static_cast<unsigned int>(_text.size()), width, line, column});
+    for (unsigned int i = 0; i < width; i++) {
+        _glyphs.push_back(layout(' ', line, column + i));
+    }
+    _text.append(width, ' ');
+
+    // the panel covers every cell, so it does not move when fields change
+    Box2 lineBox;
+    lineBox.min = glm::vec2(0, -LINE_HEIGHT * static_cast<float>(line) - 0.3f);
+    lineBox.max = glm::vec2(_advance * static_cast<float>(column + width), lineBox.min.y + 1.0f);
+    if (line == 0) {
+        _box = lineBox;
+    } else {
+        _box.extend(lineBox);
+    }
+
+    _panel = _box;
+    _panel.inflate(glm::vec2(0.5));
+    _glyphs[0] = {_panel.min, _panel.max - _panel.min, glm::vec4(0), PANEL};
+
+    _uploaded = false;
+    return static_cast<unsigned int>(_fields.size() - 1);
+}
+
+void Hud::write(const unsigned int field, const std::string_view text) {
+    const auto& [glyph, start, width, line, column] = _fields[field];
+
+    // only the span of characters that changed is uploaded
+    unsigned int first = width, last = 0;
+    for (unsigned int i = 0; i < width; i++) {
+        const char c = i < text.size() ? text[i] : ' ';
+        if (_text[start + i] != c) {
+            _text[start + i] = c;
+            _glyphs[glyph + i] = layout(c, line, column + i);
+            first = std::min(first, i);
+            last = i;
+        }
+    }
+
+    if (first <= last && _uploaded) {
+        _buffer.use();
+        VertexBuffer::setSubData(sizeof(HudGlyph) * (glyph + first), sizeof(HudGlyph) * (last - first + 1), &_glyphs[glyph + first]);
+        VertexBuffer::clearUse();
+    }
+}
+
+HudGlyph Hud::layout(unsigned char c, const unsigned int line, const unsigned int column) const {
+    if (c >= 128) {
+        c = '?';
+    }
+    const Character& character = _font.getCharacter(c);
+    const glm::vec2 position(_advance * static_cast<float>(column) + character.bearing.x, -LINE_HEIGHT * static_cast<float>(line) + character.bearing.y - character.size.y);
+    return {position, character.size, character.uv, c};
+}
+
+void Hud::setColors(const glm::vec3& text, const glm::vec4& panel) const {
+    _shader.use();
+    _textColor.setVec3(text);
+    _panelColor.setVec4(panel);
+}
+
+const Box2& Hud::getBox() const {
+    return _panel;
+}
+
+void Hud::render(const glm::mat4& transformation) {
+    if (!_uploaded) {
+        _buffer.use();
+        VertexBuffer::setData(_glyphs, GL_DYNAMIC_DRAW);
+        VertexBuffer::clearUse();
+        _uploaded = true;
+    }
+
+    _shader.use();
+    _transformation.setMat4(transformation);
+    _font.useTexture();
+
+    _attributes.use();
+    VertexAttributes::draw(GL_POINTS, _glyphs.size());
+    VertexAttributes::clearUse();
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_HUD_HPP
+#define NIHILO_HUD_HPP
+
+#include <algorithm>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "font.hpp"
+#include "shader.hpp"
+#include "vertex.hpp"
+#include "../box.hpp"
+
+struct HudGlyph {
+    glm::vec2 position, size;
+    glm::vec4 uv;
+    unsigned char character;
+};
+
+/**
+ * Text overlay made of lines with a static label followed by a fixed width field.
+ *
+ * Every character has its own glyph slot in a persistent buffer, laid out once on the monospaced font.
+ * Updating a field only rewrites the span of characters that changed, and the panel behind the text
+ * is drawn in the same pass as a special glyph.
+ */
+class Hud {
+
+    public:
+
+    static constexpr unsigned int MAX_FIELD_WIDTH = 64;
+
+    explicit Hud(const Font& font);
+
+    /**
+     * Appends a line to the overlay.
+     * @param label The static text at the beginning of the line
+     * @param width The number of characters of the field following the label
+     * @return The field index
+     */
+    unsigned int addLine(std::string_view label, unsigned int width = 0);
+
+    /**
+     * Formats a field without allocating, text longer than the field is truncated.
+     * @param field The field index
+     */
+    template<typename... Args>
+    void setField(const unsigned int field, std::format_string<Args...> format, Args&&... args) {
+        char buffer[MAX_FIELD_WIDTH];
+        const auto result = std::format_to_n(buffer, MAX_FIELD_WIDTH, format, std::forward<Args>(args)...);
+        write(field, std::string_view(buffer, std::min<size_t>(result.size, MAX_FIELD_WIDTH)));
+    }
+
+    void setColors(const glm::vec3& text, const glm::vec4& panel) const;
+
+    /**
+     * @return The box of the panel, stable whatever the content of the fields
+     */
+    [[nodiscard]] const Box2& getBox() const;
+
+    void render(const glm::mat4& transformation);
+
+    private:
+
+    struct Field {
+        unsigned int glyph, text; // index of the first glyph and of the first character
+        unsigned int width, line, column;
+    };
+
+    void write(unsigned int field, std::string_view text);
+
+    [[nodiscard]] HudGlyph layout(unsigned char c, unsigned int line, unsigned int column) const;
+
+    const Font& _font;
+    Shader _shader;
+    Uniform _transformation, _textColor, _panelColor;
+    VertexAttributes _attributes;
+    VertexBuffer _buffer;
+    std::vector<HudGlyph> _glyphs; // the panel first, then every character
+    std::vector<Field> _fields;
+    std::string _text; // current characters of the fields
+    Box2 _box, _panel;
+    unsigned int _lines;
+    float _advance;
+    bool _uploaded;
+};
+
+#endif //NIHILO_HUD_HPP
@@ -22,8 +22,11 @@
 
 #include "renderer.hpp"
 
-#include <format>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <limits>
 
 #include "glad.h"
 #include "glm/glm.hpp"
@@ -37,12 +40,15 @@ const std::string particleVertex = R"(
 layout (location = 0) in vec3 position;
 layout (location = 1) in float radius;
 layout (location = 2) in vec3 color;
+layout (location = 3) in vec3 previousPosition;
 
 flat out float geomRadius;
 flat out vec3 geomColor;
 
+uniform float alpha;
+
 void main() {
-    gl_Position = vec4(position, 1);
+    gl_Position = vec4(mix(previousPosition, position, alpha), 1);
     geomRadius = radius;
     geomColor = color;
 }
@@ -62,12 +68,22 @@ flat out float radius2;
 flat out vec3 fragColor;
 out vec2 offset;
 
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec2 viewport;
+    float time;
+};
+
+uniform float spriteSize;
 
 void main() {
     vec4 pos = view * gl_in[0].gl_Position;
     float radius = geomRadius[0];
+    // small particles are drawn as point sprites instead
+    if (-pos.z > 0 && radius * projection[1][1] * viewport.y < spriteSize * -pos.z) {
+        return;
+    }
     radius2 = radius * radius;
     fragColor = geomColor[0];
     offset = vec2(-radius, -radius);
@@ -86,6 +102,129 @@ void main() {
 }
 )";
 
+// language=glsl
+const std::string cullGeometry = R"(
+#version 330 core
+
+layout (points) in;
+layout (points, max_vertices = 1) out;
+
+flat in float[] geomRadius;
+flat in vec3[] geomColor;
+
+out vec3 culledPosition;
+out float culledRadius;
+out vec3 culledColor;
+
+uniform vec4 planes[6];
+
+void main() {
+    vec3 position = gl_in[0].gl_Position.xyz;
+    float radius = geomRadius[0];
+    for (int i = 0; i < 6; i++) {
+        if (dot(planes[i].xyz, position) + planes[i].w < -radius * length(planes[i].xyz)) {
+            return;
+        }
+    }
+    culledPosition = position;
+    culledRadius = radius;
+    culledColor = geomColor[0];
+    EmitVertex();
+    EndPrimitive();
+}
+)";
+
+// language=glsl
+const std::string instancedVertex = R"(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in float radius;
+layout (location = 2) in vec3 color;
+layout (location = 3) in vec3 previousPosition;
+layout (location = 4) in vec2 corner;
+
+flat out float radius2;
+flat out vec3 fragColor;
+out vec2 offset;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec2 viewport;
+    float time;
+};
+
+uniform float alpha;
+uniform float spriteSize;
+
+void main() {
+    vec4 pos = view * vec4(mix(previousPosition, position, alpha), 1);
+    radius2 = radius * radius;
+    fragColor = color;
+    offset = corner * radius;
+    // small particles are drawn as point sprites instead, the degenerate quad is clipped
+    if (-pos.z > 0 && radius * projection[1][1] * viewport.y < spriteSize * -pos.z) {
+        gl_Position = vec4(2, 2, 2, 1);
+        return;
+    }
+    gl_Position = projection * (pos + vec4(offset, 0, 0));
+}
+)";
+
+// language=glsl
+const std::string spriteVertex = R"(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in float radius;
+layout (location = 2) in vec3 color;
+layout (location = 3) in vec3 previousPosition;
+
+flat out vec3 fragColor;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec2 viewport;
+    float time;
+};
+
+uniform float alpha;
+uniform float spriteSize;
+
+void main() {
+    vec4 pos = view * vec4(mix(previousPosition, position, alpha), 1);
+    float size = radius * projection[1][1] * viewport.y / -pos.z; // diameter in pixels
+    fragColor = color;
+    // large particles are drawn as billboards instead
+    if (-pos.z <= 0 || size >= spriteSize) {
+        gl_Position = vec4(2, 2, 2, 1);
+        gl_PointSize = 1;
+        return;
+    }
+    gl_Position = projection * pos;
+    gl_PointSize = max(size, 1);
+}
+)";
+
+// language=glsl
+const std::string spriteFragment = R"(
+#version 330 core
+
+flat in vec3 fragColor;
+
+out vec4 color;
+
+void main() {
+    vec2 offset = gl_PointCoord * 2 - 1;
+    if (dot(offset, offset) > 1) {
+        discard;
+    }
+    color = vec4(fragColor, 1);
+}
+)";
+
 // language=glsl
 const std::string particleFragment = R"(
 #version 330 core
@@ -105,34 +244,572 @@ void main() {
 }
 )";
 
+// language=glsl
+const std::string smoothFragment = R"(
+#version 330 core
+
+flat in float radius2;
+flat in vec3 fragColor;
+in vec2 offset;
+
+out vec4 color;
+
+void main() {
+    // coverage of the pixel by the disc edge, about one pixel wide whatever the size, written as alpha to coverage
+    float distance = length(offset);
+    float coverage = clamp((sqrt(radius2) - distance) / fwidth(distance) + 0.5, 0, 1);
+    if (coverage == 0) {
+        discard;
+    }
+    color = vec4(fragColor, coverage);
+}
+)";
+
+// language=glsl
+const std::string smoothSpriteFragment = R"(
+#version 330 core
+
+flat in vec3 fragColor;
+
+out vec4 color;
+
+void main() {
+    float distance = length(gl_PointCoord * 2 - 1);
+    float coverage = clamp((1 - distance) / fwidth(distance) + 0.5, 0, 1);
+    if (coverage == 0) {
+        discard;
+    }
+    color = vec4(fragColor, coverage);
+}
+)";
+
+// language=glsl
+const std::string densityFragment = R"(
+#version 330 core
+
+flat in float radius2;
+flat in vec3 fragColor;
+in vec2 offset;
+
+out vec4 color;
+
+void main() {
+    float falloff = max(1 - dot(offset, offset) / radius2, 0);
+    color = vec4(fragColor * (falloff * falloff), 1);
+}
+)";
+
+// language=glsl
+const std::string densitySpriteFragment = R"(
+#version 330 core
+
+flat in vec3 fragColor;
+
+out vec4 color;
+
+void main() {
+    vec2 offset = gl_PointCoord * 2 - 1;
+    float falloff = max(1 - dot(offset, offset), 0);
+    color = vec4(fragColor * (falloff * falloff), 1);
+}
+)";
+
+// language=glsl
+const std::string screenVertex = R"(
+#version 330 core
+
+out vec2 uv;
+
+void main() {
+    // single triangle covering the screen
+    uv = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(uv * 2 - 1, 0, 1);
+}
+)";
+
+// language=glsl
+const std::string toneFragment = R"(
+#version 330 core
+
+in vec2 uv;
+
+out vec4 color;
+
+uniform sampler2D accumulation;
+uniform float exposure;
+
+void main() {
+    vec3 density = texture(accumulation, uv).rgb;
+    color = vec4(vec3(1) - exp(-density * exposure), 1);
+}
+)";
+
+// language=glsl
+const std::string captureVertex = R"(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+
+out vec3 capturedPosition;
+
+void main() {
+    capturedPosition = position;
+}
+)";
+
+// language=glsl
+const std::string trailVertex = R"(
+#version 330 core
+
+layout (location = 0) in vec3 position;
+layout (location = 1) in uint particle;
+layout (location = 2) in vec3 color;
+layout (location = 3) in vec3 previousPosition;
+
+out vec4 fragColor;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+    vec2 viewport;
+    float time;
+};
+
+uniform samplerBuffer trail;
+uniform float alpha;
+uniform int newest;
+uniform int count;
+uniform int particles;
+uniform int capacity;
+
+void main() {
+    // the strip starts at the particle as drawn, then goes from the newest position of the ring to the oldest, fading out
+    vec3 point;
+    if (gl_VertexID == 0) {
+        point = mix(previousPosition, position, alpha);
+    } else {
+        int slot = (newest - gl_VertexID + 1 + capacity) % capacity;
+        point = texelFetch(trail, slot * particles + int(particle)).xyz;
+    }
+    gl_Position = projection * view * vec4(point, 1);
+    fragColor = vec4(color, 1 - float(gl_VertexID) / float(count));
+}
+)";
+
+// language=glsl
+const std::string trailFragment = R"(
+#version 330 core
+
+in vec4 fragColor;
+
+out vec4 outColor;
+
+void main() {
+    outColor = fragColor;
+}
+)";
+
 constexpr float ONE_MILLISECOND = ONE_SECOND / 1000;
+constexpr float DENSITY_EXPOSURE = 1;
+constexpr unsigned int CAMERA_BINDING = 0;
+constexpr unsigned int MAPPED_SLOTS = 5; // one per snapshot of the triple buffer and two retired ones still read by the GPU
+
+// output of the cull pass, interpolation is already applied
+struct CulledParticle {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+};
+constexpr float SPRITE_SIZE = 4; // particles with a smaller projected diameter in pixels are drawn as point sprites
+constexpr float IMPOSTOR_SIZE = 16; // cells with a smaller projected diagonal in pixels are drawn as their impostor
+
+// corners of the billboard quad, drawn as a triangle strip once per particle
+constexpr glm::vec2 QUAD_CORNERS[4] = {{-1, -1}, {1, -1}, {-1, 1}, {1, 1}};
+
+/**
+ * Extracts the planes of the frustum of a clip matrix, normals pointing inside.
+ */
+void extractFrustum(const glm::mat4& clip, glm::vec4 (&planes)[6]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 4; j++) {
+            planes[2 * i][j] = clip[j][3] + clip[j][i];
+            planes[2 * i + 1][j] = clip[j][3] - clip[j][i];
+        }
+    }
+}
+
+bool intersects(const glm::vec4 (&planes)[6], const Box3& box) {
+    for (const glm::vec4& plane : planes) {
+        // corner of the box the furthest along the normal
+        const glm::vec3 corner(plane.x > 0 ? box.max.x : box.min.x, plane.y > 0 ? box.max.y : box.min.y, plane.z > 0 ? box.max.z : box.min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ParticleShader::ParticleShader(const std::string& vertex, const std::string& geometry, const std::string& fragment) :
+_shader(vertex, geometry, fragment),
+_alpha(_shader.uniform("alpha")), _spriteSize(_shader.uniform("spriteSize")) {
+    _shader.bindBlock("Camera", CAMERA_BINDING);
+}
+
+void ParticleShader::use(const float alpha, const float spriteSize) const {
+    _shader.use();
+    _alpha.setFloat(alpha);
+    _spriteSize.setFloat(spriteSize);
+}
 
 Renderer::Renderer() :
-_shader(particleVertex, particleGeometry, particleFragment),
-_view(_shader.uniform("view")), _projection(_shader.uniform("projection")) {
+_camera(CAMERA_BINDING, sizeof(CameraBlock)),
+_startTime(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()),
+_opaquePrograms{
+    ParticleShader(particleVertex, particleGeometry, particleFragment),
+    ParticleShader(instancedVertex, "", particleFragment),
+    ParticleShader(spriteVertex, "", spriteFragment)},
+_smoothPrograms{
+    ParticleShader(particleVertex, particleGeometry, smoothFragment),
+    ParticleShader(instancedVertex, "", smoothFragment),
+    ParticleShader(spriteVertex, "", smoothSpriteFragment)},
+_densityPrograms{
+    ParticleShader(particleVertex, particleGeometry, densityFragment),
+    ParticleShader(instancedVertex, "", densityFragment),
+    ParticleShader(spriteVertex, "", densitySpriteFragment)},
+_cullShader(particleVertex, cullGeometry, "", {"culledPosition", "culledRadius", "culledColor"}),
+_cullAlpha(_cullShader.uniform("alpha")), _cullPlanes(_cullShader.uniform("planes")),
+_mappedBuffer(MAPPED_SLOTS), _mappedPositions(false), _positionsUploaded(false), _previousCapacity(0), _previousGeneration(0), _previousParticleGeneration(0), _previousTimestamp(0), _previousValid(false), _animating(false),
+_captureShader(captureVertex, "", "", {"capturedPosition"}), _generation(std::numeric_limits<unsigned long long>::max()),
+_toneShader(screenVertex, "", toneFragment), _exposure(_toneShader.uniform("exposure")),
+_trailShader(trailVertex, "", trailFragment), _trailAlpha(_trailShader.uniform("alpha")), _trailNewest(_trailShader.uniform("newest")),
+_trailCount(_trailShader.uniform("count")), _trailParticles(_trailShader.uniform("particles")), _trailCapacity(_trailShader.uniform("capacity")), _trailGeneration(std::numeric_limits<unsigned long long>::max()), _trailLayout(std::numeric_limits<unsigned long long>::max()),
+_hud(_font) {
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_SAMPLE_SHADING);
     glMinSampleShading(1);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    // slots are handed to the simulation thread, the mapping must never be recreated afterwards
+    if (_mappedBuffer.isPersistent()) {
+        _mappedBuffer.reserve(sizeof(glm::vec3) * MAPPED_CAPACITY);
+    }
+    for (unsigned int slot = 0; slot < MAPPED_SLOTS; slot++) {
+        _freeSlots.push_back(slot);
+    }
 
     _attributes.use();
-    _buffer.use();
-    VertexAttributes::setFloat(0, 3, sizeof(ParticleSnapshot), offsetof(ParticleSnapshot, position));
-    VertexAttributes::setFloat(1, 1, sizeof(ParticleSnapshot), offsetof(ParticleSnapshot, radius));
-    VertexAttributes::setFloat(2, 3, sizeof(ParticleSnapshot), offsetof(ParticleSnapshot, color));
+    _attributeBuffer.use();
+    VertexAttributes::setFloat(1, 1, sizeof(ParticleAttributes), offsetof(ParticleAttributes, radius));
+    VertexAttributes::setFloat(2, 3, sizeof(ParticleAttributes), offsetof(ParticleAttributes, color));
+
+    // the instanced path shares the particle buffers, advancing once per quad instead of once per vertex
+    // attributes are pointed to the first particle of each drawn range, see setInstances
+    _instancedAttributes.use();
+    for (unsigned int i = 0; i < 4; i++) {
+        VertexAttributes::setDivisor(i, 1);
+    }
+    _quadBuffer.use();
+    VertexBuffer::setData(sizeof(QUAD_CORNERS), QUAD_CORNERS, GL_STATIC_DRAW);
+    VertexAttributes::setFloat(4, 2, sizeof(glm::vec2), 0);
+
+    _culledAttributes.use();
+    _culledBuffer.use();
+    VertexAttributes::setFloat(0, 3, sizeof(CulledParticle), offsetof(CulledParticle, position));
+    VertexAttributes::setFloat(1, 1, sizeof(CulledParticle), offsetof(CulledParticle, radius));
+    VertexAttributes::setFloat(2, 3, sizeof(CulledParticle), offsetof(CulledParticle, color));
+
+    // previous positions are gathered from their index in the previous order, see permutePrevious
+    _permuteAttributes.use();
+    _previousBuffer.use();
+    VertexAttributes::setFloat(0, 3, sizeof(glm::vec3), 0);
+    _permutationBuffer.useIndices();
     VertexBuffer::clearUse();
     VertexAttributes::clearUse();
 
-    _rectangle.setColor(glm::vec4(0.2, 0.2, 0.2, 0.9));
-    _font.setColor(glm::vec3(0.5, 0.8, 0.2));
+    // one line strip per particle, instances follow the order of the attribute buffer
+    // positions are pointed to the current snapshot like the particles, see setPositions
+    _trailAttributes.use();
+    for (unsigned int i = 0; i < 4; i++) {
+        VertexAttributes::setDivisor(i, 1);
+    }
+    _trailOrderBuffer.use();
+    VertexAttributes::setUnsignedInt(1, 1, sizeof(unsigned int), 0);
+    _attributeBuffer.use();
+    VertexAttributes::setFloat(2, 3, sizeof(ParticleAttributes), offsetof(ParticleAttributes, color));
+    VertexBuffer::clearUse();
+    VertexAttributes::clearUse();
+
+    _trailShader.bindBlock("Camera", CAMERA_BINDING);
+
+    _hud.addLine("Simulation:");
+    _simulationPeriodField = _hud.addLine("", 20);
+    _simulationFrequencyField = _hud.addLine("", 12);
+    _hud.addLine("Render:");
+    _renderPeriodField = _hud.addLine("", 20);
+    _renderFrequencyField = _hud.addLine("", 12);
+    _hud.addLine("");
+    _fovField = _hud.addLine("FOV: ", 8);
+    _positionField = _hud.addLine("Pos: ", 32);
+    _speedField = _hud.addLine("Speed: ", 8);
+    _hud.setColors(glm::vec3(0.5, 0.8, 0.2), glm::vec4(0.2, 0.2, 0.2, 0.9));
+}
+
+bool Renderer::attachMapping(SimulationSnapshot& snapshot, const unsigned long long capacity) {
+    if (!_mappedBuffer.isPersistent() || _freeSlots.empty() || sizeof(glm::vec3) * capacity > _mappedBuffer.getCapacity()) {
+        return false;
+    }
+    const unsigned int slot = _freeSlots.front();
+    _freeSlots.pop_front();
+    snapshot.mapping = static_cast<glm::vec3*>(_mappedBuffer.getSlot(slot));
+    snapshot.mappingCapacity = capacity;
+    snapshot.mappingSlot = slot;
+    return true;
+}
+
+void Renderer::retire(SimulationSnapshot& snapshot) {
+    _previousValid = _positionsUploaded;
+    if (_positionsUploaded) {
+        StreamBuffer& source = _mappedPositions ? _mappedBuffer : _positionBuffer;
+        const unsigned long long size = sizeof(glm::vec3) * snapshot.attributes.size();
+        if (size > _previousCapacity) {
+            _previousBuffer.use();
+            VertexBuffer::setData(size, nullptr, GL_STREAM_COPY);
+            _previousCapacity = size;
+        }
+        source.use();
+        _previousBuffer.copyFrom(source.getOffset(), size);
+        VertexBuffer::clearUse();
+        source.fence();
+
+        // the order only changes with the layout
+        if (_previousOrder.empty() || snapshot.generation != _previousGeneration) {
+            _previousOrder.assign(snapshot.order.begin(), snapshot.order.end());
+        }
+        _previousGeneration = snapshot.generation;
+        _previousParticleGeneration = snapshot.particleGeneration;
+        _previousTimestamp = snapshot.timestamp;
+        _positionsUploaded = false;
+    }
+
+    // the retired slot was fenced by this frame, the one given back was fenced frames ago and is most likely free
+    if (snapshot.mapping) {
+        _freeSlots.push_back(snapshot.mappingSlot);
+        const unsigned int slot = _freeSlots.front();
+        _freeSlots.pop_front();
+        _mappedBuffer.wait(slot);
+        snapshot.mapping = static_cast<glm::vec3*>(_mappedBuffer.getSlot(slot));
+        snapshot.mappingSlot = slot;
+    }
+}
+
+void Renderer::setPositions(const VertexAttributes& attributes) const {
+    // the position attribute points to the slot holding the current snapshot
+    attributes.use();
+    const StreamBuffer& source = _mappedPositions ? _mappedBuffer : _positionBuffer;
+    source.use();
+    VertexAttributes::setFloat(0, 3, sizeof(glm::vec3), static_cast<unsigned int>(source.getOffset()));
+
+    if (_previousValid) {
+        _previousBuffer.use();
+        VertexAttributes::setFloat(3, 3, sizeof(glm::vec3), 0);
+    } else {
+        VertexAttributes::disable(3);
+    }
+}
+
+void Renderer::setInstances(const int first) const {
+    // there is no base instance in GL 4.0, every attribute is offset to the first instance instead
+    const auto index = static_cast<unsigned int>(first);
+    const StreamBuffer& source = _mappedPositions ? _mappedBuffer : _positionBuffer;
+    source.use();
+    VertexAttributes::setFloat(0, 3, sizeof(glm::vec3), static_cast<unsigned int>(source.getOffset()) + index * sizeof(glm::vec3));
+    _attributeBuffer.use();
+    VertexAttributes::setFloat(1, 1, sizeof(ParticleAttributes), index * sizeof(ParticleAttributes) + offsetof(ParticleAttributes, radius));
+    VertexAttributes::setFloat(2, 3, sizeof(ParticleAttributes), index * sizeof(ParticleAttributes) + offsetof(ParticleAttributes, color));
+    if (_previousValid) {
+        _previousBuffer.use();
+        VertexAttributes::setFloat(3, 3, sizeof(glm::vec3), index * sizeof(glm::vec3));
+    } else {
+        VertexAttributes::disable(3);
+    }
+}
+
+void Renderer::updateTrails(const SimulationSnapshot& simulation) {
+    const size_t particleCount = simulation.order.size();
+
+    // the ring is indexed like the simulation, so trails survive the reordering of the particles by cell
+    // indices designate other particles once particles are added or removed
+    if (simulation.particleGeneration != _trailGeneration || particleCount != _trails.getParticles()) {
+        _trails.reset(particleCount);
+        _trailGeneration = simulation.particleGeneration;
+    }
+    if (particleCount == 0) {
+        return;
+    }
+
+    // the order and its inverse only change with the layout, not every tick
+    if (simulation.generation != _trailLayout) {
+        _trailIndices.resize(particleCount);
+        for (size_t i = 0; i < particleCount; i++) {
+            _trailIndices[simulation.order[i]] = static_cast<unsigned int>(i);
+        }
+        _trailOrderBuffer.use();
+        VertexBuffer::setData(simulation.order, GL_STATIC_DRAW);
+        _trailIndexBuffer.use();
+        VertexBuffer::setData(_trailIndices, GL_STATIC_DRAW);
+        _trailLayout = simulation.generation;
+    }
+
+    // positions are only sampled every few ticks, so that trails span whole orbits
+    if (!_trails.sample(simulation.age)) {
+        return;
+    }
+
+    // drawing the current positions in the order of the simulation writes them to the head of the ring
+    _trailCaptureAttributes.use();
+    const StreamBuffer& source = _mappedPositions ? _mappedBuffer : _positionBuffer;
+    source.use();
+    VertexAttributes::setFloat(0, 3, sizeof(glm::vec3), static_cast<unsigned int>(source.getOffset()));
+    _trailIndexBuffer.useIndices();
+
+    _captureShader.use();
+    _trails.begin();
+    VertexAttributes::drawIndexed(GL_POINTS, particleCount);
+    TrailBuffer::end();
+    VertexAttributes::clearUse();
+    VertexBuffer::clearUse();
+}
+
+void Renderer::permutePrevious(const SimulationSnapshot& simulation) {
+    const size_t particleCount = simulation.order.size();
+    if (particleCount == 0) {
+        return;
+    }
+
+    // both orders map snapshot indices to simulation indices, the previous one is inverted to compose them
+    _previousIndices.resize(particleCount);
+    for (size_t i = 0; i < particleCount; i++) {
+        _previousIndices[_previousOrder[i]] = static_cast<unsigned int>(i);
+    }
+    _permutation.resize(particleCount);
+    for (size_t i = 0; i < particleCount; i++) {
+        _permutation[i] = _previousIndices[simulation.order[i]];
+    }
+    _permutationBuffer.use();
+    VertexBuffer::setData(_permutation, GL_STREAM_DRAW);
+
+    const unsigned long long particleSize = sizeof(glm::vec3) * particleCount;
+    _permutedBuffer.reserve(particleSize);
+    _captureShader.use();
+    _permuteAttributes.use();
+    _permutedBuffer.begin(GL_POINTS);
+    VertexAttributes::drawIndexed(GL_POINTS, particleCount);
+    FeedbackBuffer::end();
+    VertexAttributes::clearUse();
+
+    const unsigned long long size = sizeof(glm::vec3) * simulation.attributes.size();
+    if (size > _previousCapacity) {
+        _previousBuffer.use();
+        VertexBuffer::setData(size, nullptr, GL_STREAM_COPY);
+        _previousCapacity = size;
+    }
+    _permutedBuffer.use();
+    _previousBuffer.copyFrom(0, particleSize);
+
+    // cells changed with the order, their impostors do not move for this snapshot
+    const StreamBuffer& source = _mappedPositions ? _mappedBuffer : _positionBuffer;
+    source.use();
+    _previousBuffer.copyFrom(source.getOffset() + particleSize, size - particleSize, particleSize);
+    VertexBuffer::clearUse();
+}
+
+void Renderer::cull(const ControlSnapshot& control, const SimulationSnapshot& simulation, const glm::mat4& view, const glm::mat4& projection) {
+    _firsts.clear();
+    _counts.clear();
+
+    const size_t cellCount = simulation.cells.size();
+    const auto particleCount = static_cast<int>(simulation.attributes.size() - cellCount);
+    if (!control.culling || cellCount == 0) {
+        addRange(0, particleCount);
+        return;
+    }
+
+    glm::vec4 planes[6];
+    extractFrustum(projection * view, planes);
+    const float pixels = projection[1][1] * static_cast<float>(control.height) / 2;
+
+    for (size_t i = 0; i < cellCount; i++) {
+        const SnapshotCell& cell = simulation.cells[i];
+        if (!intersects(planes, cell.bounds)) {
+            continue;
+        }
+
+        // distant cells collapse into their impostor
+        const float size = glm::length(cell.bounds.max - cell.bounds.min);
+        if (const float distance = glm::length((cell.bounds.min + cell.bounds.max) * 0.5f - control.position); distance > size && size * pixels < IMPOSTOR_SIZE * distance) {
+            addRange(particleCount + static_cast<int>(i), 1);
+        } else {
+            addRange(static_cast<int>(cell.begin), static_cast<int>(cell.count));
+        }
+    }
+}
+
+void Renderer::addRange(const int first, const int count) {
+    if (!_firsts.empty() && _firsts.back() + _counts.back() == first) {
+        _counts.back() += count;
+    } else {
+        _firsts.push_back(first);
+        _counts.push_back(count);
+    }
+}
+
+bool Renderer::isAnimating() const {
+    return _animating;
 }
 
 void Renderer::render(const ControlSnapshot& control, const SimulationSnapshot& simulation, const bool simulationChanged, const ManagerTiming& timing) {
     if (simulationChanged) {
-        _buffer.use();
-        VertexBuffer::setData(simulation.particles, GL_DYNAMIC_DRAW);
+        // attributes only change when particles are added or removed
+        if (simulation.generation != _generation) {
+            _attributeBuffer.use();
+            VertexBuffer::setData(simulation.attributes, GL_STATIC_DRAW);
+            _generation = simulation.generation;
+        }
+
+        _mappedPositions = simulation.mapped;
+        if (_mappedPositions) {
+            // the simulation already wrote positions into the slot of the snapshot
+            _mappedBuffer.select(simulation.mappingSlot);
+        } else {
+            // positions go to the next slot of the ring
+            const unsigned long long size = sizeof(glm::vec3) * simulation.positions.size();
+            _positionBuffer.reserve(size);
+            std::memcpy(_positionBuffer.acquire(), simulation.positions.data(), size);
+            _positionBuffer.use();
+            _positionBuffer.commit(size);
+        }
+        _positionsUploaded = true;
+
+        // interpolation needs the same particles in both snapshots, possibly in another order
+        if (_previousValid && _previousGeneration != simulation.generation) {
+            _previousValid = _previousParticleGeneration == simulation.particleGeneration && _previousOrder.size() == simulation.order.size();
+            if (_previousValid) {
+                permutePrevious(simulation);
+            }
+        }
+
+        setPositions(_attributes);
+        setPositions(_trailAttributes);
         VertexBuffer::clearUse();
+        VertexAttributes::clearUse();
+
+        if (control.trails) {
+            updateTrails(simulation);
+        } else {
+            _trails.clear();
+        }
     }
 
     glViewport(0, 0, control.width, control.height);
@@ -144,30 +821,145 @@ void Renderer::render(const ControlSnapshot& control, const SimulationSnapshot&
     const auto projection = glm::perspective(glm::radians(control.fov), aspect, 0.01f, 10000.0f);
     const auto view = glm::lookAt(control.position, control.position + control.forward, control.up);
 
-    _shader.use();
-    _view.setMat4(view);
-    _projection.setMat4(projection);
+    // the camera is uploaded once and read by every program through the Camera block
+    const long long now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const CameraBlock camera{view, projection, glm::vec2(control.width, control.height), static_cast<float>((now - _startTime) / ONE_SECOND), 0};
+    _camera.setData(&camera);
 
-    _attributes.use();
-    VertexAttributes::draw(GL_POINTS, simulation.particles.size());
+    // positions are shown one simulation period late, moving from the previous snapshot to the current one
+    float alpha = 1;
+    if (_previousValid && simulation.timestamp > _previousTimestamp) {
+        alpha = std::clamp(static_cast<float>(now - simulation.timestamp) / static_cast<float>(simulation.timestamp - _previousTimestamp), 0.0f, 1.0f);
+    }
+    _animating = alpha < 1;
+
+    // density is accumulated additively in a float framebuffer, without depth nor per-sample shading
+    // smooth discs compute their coverage analytically once per pixel and turn it into a sample mask,
+    // so edges are depth tested per sample like with sample shading and overlapping discs need no sorting
+    const ParticlePrograms& programs = control.density ? _densityPrograms : control.smooth ? _smoothPrograms : _opaquePrograms;
+    const bool smooth = control.smooth && !control.density;
+    if (smooth) {
+        glDisable(GL_SAMPLE_SHADING);
+        glDisable(GL_BLEND);
+        glEnable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+    }
+    if (control.density) {
+        _accumulation.resize(control.width, control.height);
+        _accumulation.use();
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_SAMPLE_SHADING);
+        glDepthMask(GL_FALSE);
+        glBlendFunc(GL_ONE, GL_ONE);
+    }
+
+    // each particle is drawn by exactly one of the passes depending on its projected size
+    const float spriteSize = control.sprites ? SPRITE_SIZE : 0;
+    if (control.gpuCulling) {
+        // the cull pass writes visible particles to a buffer drawn as is, the count never comes back to the CPU
+        const size_t particleCount = simulation.attributes.size() - simulation.cells.size();
+        _culledBuffer.reserve(sizeof(CulledParticle) * particleCount);
+
+        glm::vec4 planes[6];
+        extractFrustum(projection * view, planes);
+        _cullShader.use();
+        _cullAlpha.setFloat(alpha);
+        _cullPlanes.setVec4(planes, 6);
+        _attributes.use();
+        _culledBuffer.begin(GL_POINTS);
+        VertexAttributes::draw(GL_POINTS, particleCount);
+        FeedbackBuffer::end();
+
+        // transform feedback draws cannot be instanced in GL 4.0, billboards use the geometry shader
+        programs.billboard.use(1, spriteSize);
+        _culledAttributes.use();
+        _culledBuffer.draw(GL_POINTS);
+        if (control.sprites) {
+            programs.sprite.use(1, spriteSize);
+            _culledBuffer.draw(GL_POINTS);
+        }
+    } else {
+        cull(control, simulation, view, projection);
+        if (control.instanced) {
+            programs.instanced.use(alpha, spriteSize);
+            _instancedAttributes.use();
+            for (size_t i = 0; i < _firsts.size(); i++) {
+                setInstances(_firsts[i]);
+                VertexAttributes::drawInstanced(GL_TRIANGLE_STRIP, 4, _counts[i]);
+            }
+            VertexBuffer::clearUse();
+        } else {
+            programs.billboard.use(alpha, spriteSize);
+            _attributes.use();
+            VertexAttributes::multiDraw(GL_POINTS, _firsts, _counts);
+        }
+        if (control.sprites) {
+            programs.sprite.use(alpha, spriteSize);
+            _attributes.use();
+            VertexAttributes::multiDraw(GL_POINTS, _firsts, _counts);
+        }
+    }
     VertexAttributes::clearUse();
 
+    if (smooth) {
+        glDisable(GL_SAMPLE_ALPHA_TO_COVERAGE);
+        glEnable(GL_BLEND);
+        glEnable(GL_SAMPLE_SHADING);
+    }
+
+    if (control.density) {
+        Framebuffer::clearUse();
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        // tone mapping resolve to the window, shaded once per pixel
+        _toneShader.use();
+        _exposure.setFloat(DENSITY_EXPOSURE);
+        _accumulation.useTexture();
+        _screenAttributes.use();
+        VertexAttributes::draw(GL_TRIANGLES, 3);
+        VertexAttributes::clearUse();
+        glEnable(GL_SAMPLE_SHADING);
+        glEnable(GL_DEPTH_TEST);
+    }
+
     glDepthMask(GL_FALSE);
 
+    // a head captured at the current snapshot is ahead of the interpolated particle, the strip starts one slot back
+    const unsigned int skipped = _trails.isHeadCurrent() ? 1 : 0;
+    if (control.trails && _trails.getCount() > skipped) {
+        const unsigned int capacity = _trails.getCapacity();
+        const unsigned int count = _trails.getCount() - skipped;
+        _trailShader.use();
+        _trailAlpha.setFloat(alpha);
+        _trailNewest.setInt(static_cast<int>((_trails.getHead() + capacity - skipped) % capacity));
+        _trailCount.setInt(static_cast<int>(count));
+        _trailParticles.setInt(static_cast<int>(_trails.getParticles()));
+        _trailCapacity.setInt(static_cast<int>(capacity));
+        _trails.useTexture();
+        _trailAttributes.use();
+        VertexAttributes::drawInstanced(GL_LINE_STRIP, count + 1, _trails.getParticles());
+        VertexAttributes::clearUse();
+    }
+
+    // the trails read the current positions too
+    (_mappedPositions ? _mappedBuffer : _positionBuffer).fence();
+
     const glm::vec3 scale(0.02, 0.02 * aspect, 0);
 
     if (control.debug) {
-        Box2 box = _font.setText(std::format(
-            "Simulation:\n{:05.2f} / {:05.2f} ms\n{:05.2f} Hz\nRender:\n{:05.2f} / {:05.2f} ms\n{:05.2f} Hz\n\nFOV: {:.2f}\nPos: {:.2f}, {:.2f}, {:.2f}\nSpeed: {:.2f}",
-            static_cast<float>(timing.simulation.currentPeriod) / ONE_MILLISECOND, static_cast<float>(timing.simulation.targetPeriod) / ONE_MILLISECOND, timing.simulation.getFrequency(),
-            static_cast<float>(timing.render.currentPeriod) / ONE_MILLISECOND, static_cast<float>(timing.render.targetPeriod) / ONE_MILLISECOND, timing.render.getFrequency(),
-            control.fov, control.position.x, control.position.y, control.position.z, control.speed));
-        box.inflate(glm::vec2(0.5));
-        _rectangle.setBox(box);
+        // fields only upload the characters that changed
+        _hud.setField(_simulationPeriodField, "{:05.2f} / {:05.2f} ms", static_cast<float>(timing.simulation.currentPeriod) / ONE_MILLISECOND, static_cast<float>(timing.simulation.targetPeriod) / ONE_MILLISECOND);
+        _hud.setField(_simulationFrequencyField, "{:05.2f} Hz", timing.simulation.getFrequency());
+        _hud.setField(_renderPeriodField, "{:05.2f} / {:05.2f} ms", static_cast<float>(timing.render.currentPeriod) / ONE_MILLISECOND, static_cast<float>(timing.render.targetPeriod) / ONE_MILLISECOND);
+        _hud.setField(_renderFrequencyField, "{:05.2f} Hz", timing.render.getFrequency());
+        _hud.setField(_fovField, "{:.2f}", control.fov);
+        _hud.setField(_positionField, "{:.2f}, {:.2f}, {:.2f}", control.position.x, control.position.y, control.position.z);
+        _hud.setField(_speedField, "{:.2f}", control.speed);
 
         // align top left
+        const Box2& box = _hud.getBox();
         const glm::mat4 transformation = glm::translate(glm::scale(glm::translate(glm::mat4(1), glm::vec3(-1, 1, 0)), scale), glm::vec3(-box.min.x, -box.max.y, 0));
-        _rectangle.render(transformation);
-        _font.render(transformation);
+        _hud.render(transformation);
     }
 }
@@ -23,29 +23,146 @@
 #ifndef NIHILO_RENDERER_HPP
 #define NIHILO_RENDERER_HPP
 
+#include <deque>
+
 #include "../timing.hpp"
 #include "../control/control.hpp"
 #include "../simulation/simulation.hpp"
+#include "feedback.hpp"
 #include "font.hpp"
-#include "rectangle.hpp"
+#include "framebuffer.hpp"
+#include "hud.hpp"
 #include "shader.hpp"
+#include "stream.hpp"
+#include "trail.hpp"
+#include "uniform.hpp"
 #include "vertex.hpp"
 
+/**
+ * Camera state of a frame, shared by every program declaring the Camera uniform block with the std140 layout.
+ */
+struct CameraBlock {
+    glm::mat4 view, projection;
+    glm::vec2 viewport;
+    float time; // seconds since the renderer was created
+    float padding;
+};
+
+/**
+ * Particle shader program with the uniforms shared by all particle rendering paths.
+ */
+class ParticleShader {
+    public:
+
+    ParticleShader(const std::string& vertex, const std::string& geometry, const std::string& fragment);
+
+    void use(float alpha, float spriteSize) const;
+
+    private:
+
+    Shader _shader;
+    Uniform _alpha, _spriteSize;
+};
+
+/**
+ * Particle shaders drawing in a given style, one per rendering path.
+ */
+struct ParticlePrograms {
+    ParticleShader billboard, instanced, sprite;
+};
+
 class Renderer {
     public:
 
+    static constexpr unsigned long long MAPPED_CAPACITY = 1 << 16; // positions per mapped slot
+
     Renderer();
 
+    /**
+     * Attaches a free slot of GPU-mapped memory to a snapshot so that its positions are written there directly.
+     * The mapped memory is allocated once, a larger capacity than MAPPED_CAPACITY is never attached.
+     * @param snapshot The snapshot
+     * @param capacity The number of positions the slot must hold
+     * @return Whether a slot was attached
+     */
+    bool attachMapping(SimulationSnapshot& snapshot, unsigned long long capacity);
+
+    /**
+     * Keeps the positions of the snapshot being replaced to interpolate from them,
+     * then swaps its mapping for the least recently retired slot before it goes back to the simulation.
+     * @param snapshot The snapshot being replaced
+     */
+    void retire(SimulationSnapshot& snapshot);
+
+    /**
+     * @return Whether the last frame was interpolated and the next one will differ even without new snapshots
+     */
+    [[nodiscard]] bool isAnimating() const;
+
     void render(const ControlSnapshot& control, const SimulationSnapshot& simulation, bool simulationChanged, const ManagerTiming& timing);
 
     private:
 
-    Shader _shader;
-    Uniform _view, _projection;
-    VertexAttributes _attributes;
-    VertexBuffer _buffer;
-    Rectangle _rectangle;
+    void setPositions(const VertexAttributes& attributes) const;
+
+    void setInstances(int first) const;
+
+    void cull(const ControlSnapshot& control, const SimulationSnapshot& simulation, const glm::mat4& view, const glm::mat4& projection);
+
+    void addRange(int first, int count);
+
+    /**
+     * Appends the positions of a new snapshot to the trails, every stride of the trail buffer.
+     */
+    void updateTrails(const SimulationSnapshot& simulation);
+
+    /**
+     * Moves the positions of the previous snapshot to the order of a new one holding the same particles,
+     * so that interpolation goes on when the simulation reorders particles by cell.
+     */
+    void permutePrevious(const SimulationSnapshot& simulation);
+
+    UniformBuffer _camera;
+    long long _startTime;
+    ParticlePrograms _opaquePrograms, _smoothPrograms, _densityPrograms;
+    Shader _cullShader;
+    Uniform _cullAlpha, _cullPlanes;
+    FeedbackBuffer _culledBuffer; // visible particles written by the cull pass
+    VertexAttributes _culledAttributes;
+    VertexAttributes _attributes, _instancedAttributes;
+    VertexBuffer _quadBuffer;
+    StreamBuffer _positionBuffer, _mappedBuffer;
+    std::deque<unsigned int> _freeSlots; // mapped slots not attached to a snapshot, least recently retired first
+    bool _mappedPositions; // whether positions are drawn from the mapped buffer
+    bool _positionsUploaded; // whether the positions of the current snapshot are on the GPU
+    VertexBuffer _previousBuffer; // positions of the previous snapshot
+    unsigned long long _previousCapacity, _previousGeneration, _previousParticleGeneration;
+    long long _previousTimestamp;
+    bool _previousValid, _animating;
+    Shader _captureShader; // copies positions gathered through an index buffer
+    VertexAttributes _permuteAttributes;
+    VertexBuffer _permutationBuffer; // index in the previous snapshot of each particle of the current one
+    FeedbackBuffer _permutedBuffer;
+    std::vector<unsigned int> _previousOrder, _previousIndices, _permutation; // order of the previous snapshot and its inverse
+    VertexBuffer _attributeBuffer;
+    unsigned long long _generation; // generation of the particle attributes in the attribute buffer
+    std::vector<int> _firsts, _counts; // ranges of visible particles and impostors
+    Framebuffer _accumulation; // additive density of the particles
+    Shader _toneShader;
+    Uniform _exposure;
+    VertexAttributes _screenAttributes;
+    Shader _trailShader;
+    Uniform _trailAlpha, _trailNewest, _trailCount, _trailParticles, _trailCapacity;
+    TrailBuffer _trails;
+    VertexAttributes _trailCaptureAttributes, _trailAttributes;
+    VertexBuffer _trailOrderBuffer; // index in the simulation of each particle, per trail instance
+    VertexBuffer _trailIndexBuffer; // inverse of the order, gathering positions in the order of the simulation
+    std::vector<unsigned int> _trailIndices;
+    unsigned long long _trailGeneration, _trailLayout; // particle generation of the ring and layout of the order buffers
     Font _font;
+    Hud _hud;
+    unsigned int _simulationPeriodField, _simulationFrequencyField, _renderPeriodField, _renderFrequencyField;
+    unsigned int _fovField, _positionField, _speedField;
 };
 
 #endif //NIHILO_RENDERER_HPP
@@ -24,12 +24,138 @@
 
 #include "shader.hpp"
 
-#include <iostream>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <random>
 #include <stdexcept>
 #include <vector>
 
 #include "glm/gtc/type_ptr.hpp"
 
+// Linked programs are cached in the per-user cache directory, named by a hash of their sources and of the driver.
+// The whole key is stored alongside the binary, any mismatch or driver rejection falls back to compiling the sources.
+
+struct BinaryHeader {
+    char magic[4];
+    unsigned int format;
+    unsigned int keyLength;
+    int length;
+};
+
+constexpr char BINARY_MAGIC[4] = {'N', 'P', 'G', 'B'};
+
+std::string programCacheKey(const std::string& vertex, const std::string& geometry, const std::string& fragment, const std::vector<const char*>& varyings) {
+    static const std::string driver = [] {
+        std::string value;
+        for (const GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const auto string = reinterpret_cast<const char*>(glGetString(name));
+            value.append(string ? string : "").push_back('\n');
+        }
+        return value;
+    }();
+
+    std::string key = driver;
+    for (const std::string* source : {&vertex, &geometry, &fragment}) {
+        key.append(*source).push_back('\0');
+    }
+    for (const char* varying : varyings) {
+        key.append(varying).push_back('\0');
+    }
+    return key;
+}
+
+std::optional<std::filesystem::path> programCacheDirectory() {
+    // XDG_CACHE_HOME on Unix, LOCALAPPDATA on Windows, with the XDG default as last resort
+    for (const char* variable : {"XDG_CACHE_HOME", "LOCALAPPDATA"}) {
+        const char* value = std::getenv(variable);
+        if (value && std::filesystem::path(value).is_absolute()) {
+            return std::filesystem::path(value) / "nihilo" / "shaders";
+        }
+    }
+    const char* home = std::getenv("HOME");
+    if (home && std::filesystem::path(home).is_absolute()) {
+        return std::filesystem::path(home) / ".cache" / "nihilo" / "shaders";
+    }
+    return std::nullopt;
+}
+
+bool loadProgramBinary(const unsigned int program, const std::filesystem::path& path, const std::string& key) {
+    std::error_code error;
+    const std::uintmax_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    BinaryHeader header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader)) || std::memcmp(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        return false;
+    }
+
+    // the lengths are only trusted once they account for the exact file size
+    if (header.keyLength != key.size() || header.length <= 0 || size != sizeof(BinaryHeader) + header.keyLength + static_cast<std::uintmax_t>(header.length)) {
+        return false;
+    }
+
+    // a hash collision would otherwise load the program of other sources
+    std::string storedKey(header.keyLength, '\0');
+    if (!file.read(storedKey.data(), header.keyLength) || storedKey != key) {
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), header.length)) {
+        return false;
+    }
+
+    // the driver can reject a binary it produced itself, after an update for instance
+    glProgramBinary(program, header.format, binary.data(), header.length);
+    int success;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    return success;
+}
+
+void saveProgramBinary(const unsigned int program, const std::filesystem::path& path, const std::string& key) {
+    int length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    BinaryHeader header{};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    header.keyLength = static_cast<unsigned int>(key.size());
+    std::vector<char> binary(length);
+    glGetProgramBinary(program, length, &header.length, &header.format, binary.data());
+    if (header.length <= 0) {
+        return;
+    }
+
+    // written aside then renamed, so that concurrent instances never read a partial file
+    std::error_code error;
+    std::filesystem::create_directories(path.parent_path(), error);
+    std::filesystem::path temporary = path;
+    temporary += std::format(".{:x}.tmp", std::random_device()());
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        if (!file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader)) || !file.write(key.data(), static_cast<std::streamsize>(key.size())) || !file.write(binary.data(), header.length)) {
+            file.close();
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
 unsigned int compileShader(const unsigned int type, const std::string& source) {
     const auto chars = source.c_str();
     const unsigned int id = glCreateShader(type);
@@ -70,22 +196,55 @@ void Uniform::setVec4(const glm::vec4& vec) const {
     glUniform4fv(_id, 1, glm::value_ptr(vec));
 }
 
+void Uniform::setVec4(const glm::vec4* values, const int count) const {
+    glUniform4fv(_id, count, glm::value_ptr(values[0]));
+}
+
 void Uniform::setMat4(const glm::mat4& mat) const {
     glUniformMatrix4fv(_id, 1, GL_FALSE, glm::value_ptr(mat));
 }
 
-Shader::Shader(const std::string& vertex, const std::string& geometry, const std::string& fragment) {
+Shader::Shader(const std::string& vertex, const std::string& geometry, const std::string& fragment, const std::vector<const char*>& varyings) {
+    _id = glCreateProgram();
+
+    // without a cache directory the program is simply compiled every time
+    std::optional<std::filesystem::path> cacheDirectory;
+    if (GLAD_GL_ARB_get_program_binary) {
+        int formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (formats > 0) {
+            cacheDirectory = programCacheDirectory();
+        }
+    }
+
+    std::string cacheKey;
+    std::filesystem::path cachePath;
+    if (cacheDirectory) {
+        cacheKey = programCacheKey(vertex, geometry, fragment, varyings);
+        cachePath = *cacheDirectory / std::format("{:016x}.bin", std::hash<std::string>()(cacheKey));
+        if (loadProgramBinary(_id, cachePath, cacheKey)) {
+            return;
+        }
+    }
+
     std::vector<unsigned int> shaders;
     shaders.push_back(compileShader(GL_VERTEX_SHADER, vertex));
     if (!geometry.empty()) {
         shaders.push_back(compileShader(GL_GEOMETRY_SHADER, geometry));
     }
-    shaders.push_back(compileShader(GL_FRAGMENT_SHADER, fragment));
+    if (!fragment.empty()) {
+        shaders.push_back(compileShader(GL_FRAGMENT_SHADER, fragment));
+    }
 
-    _id = glCreateProgram();
     for (const unsigned int shader : shaders) {
         glAttachShader(_id, shader);
     }
+    if (!varyings.empty()) {
+        glTransformFeedbackVaryings(_id, static_cast<int>(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+    }
+    if (cacheDirectory) {
+        glProgramParameteri(_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(_id);
 
     for (const unsigned int shader : shaders) {
@@ -99,6 +258,10 @@ Shader::Shader(const std::string& vertex, const std::string& geometry, const std
         glGetProgramInfoLog(_id, 512, nullptr, infoLog + 31);
         throw std::runtime_error(infoLog);
     }
+
+    if (cacheDirectory) {
+        saveProgramBinary(_id, cachePath, cacheKey);
+    }
 }
 
 Shader::~Shader() {
@@ -110,5 +273,16 @@ void Shader::use() const {
 }
 
 Uniform Shader::uniform(const std::string &name) const {
-    return Uniform(glGetUniformLocation(_id, name.c_str()));
+    auto it = _locations.find(name);
+    if (it == _locations.end()) {
+        it = _locations.emplace(name, glGetUniformLocation(_id, name.c_str())).first;
+    }
+    return Uniform(it->second);
+}
+
+void Shader::bindBlock(const std::string& name, const unsigned int binding) const {
+    const unsigned int index = glGetUniformBlockIndex(_id, name.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(_id, index, binding);
+    }
 }
@@ -24,6 +24,8 @@
 #define NIHILO_SHADER_HPP
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "glm/glm.hpp"
 
@@ -43,6 +45,8 @@ class Uniform {
 
     void setVec4(const glm::vec4& vec) const;
 
+    void setVec4(const glm::vec4* values, int count) const;
+
     void setMat4(const glm::mat4& mat) const;
 
     private:
@@ -53,17 +57,32 @@ class Uniform {
 class Shader {
     public:
 
-    Shader(const std::string& vertex, const std::string& geometry, const std::string& fragment);
+    /**
+     * Links a program from sources, or loads it from the on-disk binary cache when the driver supports it.
+     * @param varyings Outputs captured by transform feedback, interleaved in this order
+     */
+    Shader(const std::string& vertex, const std::string& geometry, const std::string& fragment, const std::vector<const char*>& varyings = {});
 
     ~Shader();
 
     void use() const;
 
+    /**
+     * Looks up a uniform, locations are queried once per name.
+     */
     [[nodiscard]] Uniform uniform(const std::string& name) const;
 
+    /**
+     * Attaches a uniform block of the program to a binding point, does nothing if the program does not use the block.
+     * @param name The name of the block
+     * @param binding The binding point, see UniformBuffer
+     */
+    void bindBlock(const std::string& name, unsigned int binding) const;
+
     private:
 
     unsigned int _id;
+    mutable std::unordered_map<std::string, int> _locations;
 };
 
 
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "stream.hpp"
+
+#include <bit>
+
+#include "glad.h"
+
+constexpr unsigned long long MIN_CAPACITY = 1 << 16;
+constexpr GLbitfield STORAGE_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+StreamBuffer::StreamBuffer(const unsigned int slots) : _id(0), _slots(slots), _persistent(GLAD_GL_ARB_buffer_storage), _capacity(0), _slot(0), _mapping(nullptr), _fences(slots) {
+    create(MIN_CAPACITY);
+}
+
+StreamBuffer::~StreamBuffer() {
+    destroy();
+}
+
+void StreamBuffer::use() const {
+    glBindBuffer(GL_ARRAY_BUFFER, _id);
+}
+
+bool StreamBuffer::isPersistent() const {
+    return _persistent;
+}
+
+void StreamBuffer::reserve(const unsigned long long size) {
+    if (size > _capacity) {
+        destroy();
+        create(std::bit_ceil(size));
+    }
+}
+
+void* StreamBuffer::acquire() {
+    _slot = (_slot + 1) % _slots;
+    if (!_persistent) {
+        return _staging.data();
+    }
+
+    wait(_slot);
+    return _mapping + _slot * _capacity;
+}
+
+void StreamBuffer::select(const unsigned int slot) {
+    _slot = slot;
+}
+
+void StreamBuffer::wait(const unsigned int slot) {
+    if (const auto sync = static_cast<GLsync>(_fences[slot])) {
+        while (glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+        glDeleteSync(sync);
+        _fences[slot] = nullptr;
+    }
+}
+
+void* StreamBuffer::getSlot(const unsigned int slot) const {
+    return _mapping ? _mapping + slot * _capacity : nullptr;
+}
+
+void StreamBuffer::commit(const unsigned long long size) {
+    // the persistent mapping is coherent, nothing to flush
+    if (!_persistent) {
+        glBufferData(GL_ARRAY_BUFFER, static_cast<long long>(size), _staging.data(), GL_STREAM_DRAW);
+    }
+}
+
+void StreamBuffer::fence() {
+    if (!_persistent) {
+        return;
+    }
+    if (_fences[_slot]) {
+        glDeleteSync(static_cast<GLsync>(_fences[_slot]));
+    }
+    _fences[_slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+unsigned long long StreamBuffer::getOffset() const {
+    return _persistent ? _slot * _capacity : 0;
+}
+
+unsigned int StreamBuffer::getSlots() const {
+    return _slots;
+}
+
+unsigned long long StreamBuffer::getCapacity() const {
+    return _capacity;
+}
+
+void StreamBuffer::create(const unsigned long long capacity) {
+    _capacity = capacity;
+    _slot = 0;
+    if (!_persistent) {
+        glGenBuffers(1, &_id);
+        _staging.resize(capacity);
+        return;
+    }
+
+    const auto size = static_cast<long long>(capacity * _slots);
+    glGenBuffers(1, &_id);
+    glBindBuffer(GL_ARRAY_BUFFER, _id);
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, STORAGE_FLAGS);
+    _mapping = static_cast<char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, STORAGE_FLAGS));
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamBuffer::destroy() {
+    for (void*& sync : _fences) {
+        if (sync) {
+            glDeleteSync(static_cast<GLsync>(sync));
+            sync = nullptr;
+        }
+    }
+    if (_mapping) {
+        glBindBuffer(GL_ARRAY_BUFFER, _id);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        _mapping = nullptr;
+    }
+    glDeleteBuffers(1, &_id);
+    _id = 0;
+}
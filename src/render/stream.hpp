@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_STREAM_HPP
+#define NIHILO_STREAM_HPP
+
+#include <vector>
+
+/**
+ * Vertex buffer made of several slots used in turn to stream data every frame.
+ * When buffer storage is available, the slots are persistently mapped and fenced so writing never reallocates
+ * nor waits on the driver, otherwise data is staged in memory and uploaded with glBufferData.
+ */
+class StreamBuffer {
+
+    public:
+
+    static constexpr unsigned int SLOTS = 3;
+
+    /**
+     * @param slots The number of slots
+     */
+    explicit StreamBuffer(unsigned int slots = SLOTS);
+
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    void use() const;
+
+    bool isPersistent() const;
+
+    /**
+     * Grows the slots so they can hold at least the given number of bytes.
+     * Growing recreates the buffer, the content of the slots is lost.
+     * @param size The size in bytes
+     */
+    void reserve(unsigned long long size);
+
+    /**
+     * Moves to the next slot, waiting for the GPU to stop reading it.
+     * @return A pointer to the slot memory
+     */
+    void* acquire();
+
+    /**
+     * Makes the given slot current without waiting, for slots written by another thread.
+     * @param slot The slot index
+     */
+    void select(unsigned int slot);
+
+    /**
+     * Waits for the GPU to stop reading the given slot.
+     * @param slot The slot index
+     */
+    void wait(unsigned int slot);
+
+    /**
+     * @param slot The slot index
+     * @return A pointer to the slot memory, null if the buffer is not persistently mapped
+     */
+    void* getSlot(unsigned int slot) const;
+
+    /**
+     * Makes the data written in the current slot available for drawing.
+     * The buffer must be in use.
+     * @param size The number of bytes written
+     */
+    void commit(unsigned long long size);
+
+    /**
+     * Marks the end of the commands reading the current slot.
+     */
+    void fence();
+
+    /**
+     * @return The offset in bytes of the current slot in the buffer
+     */
+    unsigned long long getOffset() const;
+
+    unsigned int getSlots() const;
+
+    /**
+     * @return The size in bytes of each slot
+     */
+    unsigned long long getCapacity() const;
+
+    private:
+
+    void create(unsigned long long capacity);
+
+    void destroy();
+
+    unsigned int _id, _slots;
+    bool _persistent;
+    unsigned long long _capacity; // bytes per slot
+    unsigned int _slot;
+    char* _mapping;
+    std::vector<void*> _fences;
+    std::vector<char> _staging;
+};
+
+#endif //NIHILO_STREAM_HPP
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "trail.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "glad.h"
+#include "glm/glm.hpp"
+
+TrailBuffer::TrailBuffer(const unsigned int length, const unsigned int stride) :
+_bufferId(0), _textureId(0), _particles(0), _length(length), _stride(stride), _capacity(length), _head(length - 1), _count(0), _period(0), _current(false) {
+    if (length < 2 || stride == 0) {
+        throw std::domain_error("Trails need at least two positions and a positive stride.");
+    }
+
+    glGenBuffers(1, &_bufferId);
+    glGenTextures(1, &_textureId);
+    glBindTexture(GL_TEXTURE_BUFFER, _textureId);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGB32F, _bufferId);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+TrailBuffer::~TrailBuffer() {
+    glDeleteTextures(1, &_textureId);
+    glDeleteBuffers(1, &_bufferId);
+}
+
+void TrailBuffer::reset(const unsigned long long particles) {
+    if (particles != _particles) {
+        _particles = particles;
+        // long trails of many particles would not fit in video memory
+        const unsigned long long slotSize = sizeof(glm::vec3) * std::max(particles, 1ull);
+        _capacity = static_cast<unsigned int>(std::clamp(MAX_SIZE / slotSize, 2ull, static_cast<unsigned long long>(_length)));
+        glBindBuffer(GL_TEXTURE_BUFFER, _bufferId);
+        glBufferData(GL_TEXTURE_BUFFER, static_cast<long long>(slotSize * _capacity), nullptr, GL_DYNAMIC_COPY);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+    clear();
+}
+
+void TrailBuffer::clear() {
+    _head = _capacity - 1;
+    _count = 0;
+    _period = 0;
+    _current = false;
+}
+
+bool TrailBuffer::sample(const unsigned long long age) {
+    // sampling follows the simulation age rather than the snapshots, so that skipped frames do not stretch the trails
+    const unsigned long long period = age / _stride;
+    _current = _count == 0 || period != _period;
+    if (_current) {
+        _period = period;
+    }
+    return _current;
+}
+
+void TrailBuffer::begin() {
+    _head = (_head + 1) % _capacity;
+    _count = std::min(_count + 1, _capacity);
+
+    const unsigned long long size = sizeof(glm::vec3) * _particles;
+    glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _bufferId, static_cast<long long>(size * _head), static_cast<long long>(size));
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+}
+
+void TrailBuffer::end() {
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+}
+
+void TrailBuffer::useTexture() const {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, _textureId);
+}
+
+unsigned long long TrailBuffer::getParticles() const {
+    return _particles;
+}
+
+unsigned int TrailBuffer::getHead() const {
+    return _head;
+}
+
+unsigned int TrailBuffer::getCount() const {
+    return _count;
+}
+
+unsigned int TrailBuffer::getCapacity() const {
+    return _capacity;
+}
+
+bool TrailBuffer::isHeadCurrent() const {
+    return _current;
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_TRAIL_HPP
+#define NIHILO_TRAIL_HPP
+
+/**
+ * Ring of the last positions of every particle, kept on the GPU and read by shaders as a RGB32F texture buffer.
+ *
+ * Slot s holds the positions of all particles at one sampled tick, starting at texel s * particles.
+ * Every stride ticks, the newest positions are captured into a single slot with transform feedback,
+ * so the cost does not depend on the length of the trails.
+ */
+class TrailBuffer {
+
+    public:
+
+    // one sample every 16 days over 4096 samples spans 179 years, a whole orbit of Neptune
+    static constexpr unsigned int LENGTH = 4096; // positions per trail
+    static constexpr unsigned int STRIDE = 16; // ticks per position
+    static constexpr unsigned long long MAX_SIZE = 256ull << 20; // bytes, the length is shortened for many particles
+
+    /**
+     * @param length The maximum number of positions in each trail
+     * @param stride The number of ticks between two positions
+     */
+    explicit TrailBuffer(unsigned int length = LENGTH, unsigned int stride = STRIDE);
+
+    ~TrailBuffer();
+
+    TrailBuffer(const TrailBuffer&) = delete;
+
+    TrailBuffer& operator=(const TrailBuffer&) = delete;
+
+    /**
+     * Empties the trails and sizes the ring for a number of particles.
+     * @param particles The number of particles
+     */
+    void reset(unsigned long long particles);
+
+    /**
+     * Empties the trails, keeping the storage.
+     */
+    void clear();
+
+    /**
+     * Decides whether the positions of a snapshot are sampled, the first snapshot reaching each stride of ticks is.
+     * Sampled positions must be captured with begin and end before the next snapshot.
+     * @param age The simulation tick of the snapshot
+     * @return Whether the positions of this snapshot are to be captured
+     */
+    bool sample(unsigned long long age);
+
+    /**
+     * Advances the head of the ring and starts capturing points into it, one per particle.
+     */
+    void begin();
+
+    static void end();
+
+    /**
+     * Binds the texture buffer to the first texture unit.
+     */
+    void useTexture() const;
+
+    [[nodiscard]] unsigned long long getParticles() const;
+
+    /**
+     * @return The slot holding the newest positions
+     */
+    [[nodiscard]] unsigned int getHead() const;
+
+    /**
+     * @return The number of positions in each trail
+     */
+    [[nodiscard]] unsigned int getCount() const;
+
+    /**
+     * @return The number of slots in the ring, for the current number of particles
+     */
+    [[nodiscard]] unsigned int getCapacity() const;
+
+    /**
+     * @return Whether the head was captured from the last snapshot
+     */
+    [[nodiscard]] bool isHeadCurrent() const;
+
+    private:
+
+    unsigned int _bufferId, _textureId;
+    unsigned long long _particles;
+    unsigned int _length, _stride, _capacity;
+    unsigned int _head, _count;
+    unsigned long long _period; // stride of ticks of the last sample
+    bool _current;
+};
+
+#endif //NIHILO_TRAIL_HPP
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "uniform.hpp"
+
+#include "glad.h"
+
+UniformBuffer::UniformBuffer(const unsigned int binding, const unsigned long long size) : _id(0), _size(size) {
+    glGenBuffers(1, &_id);
+    glBindBuffer(GL_UNIFORM_BUFFER, _id);
+    glBufferData(GL_UNIFORM_BUFFER, static_cast<long long>(size), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, binding, _id);
+}
+
+UniformBuffer::~UniformBuffer() {
+    glDeleteBuffers(1, &_id);
+}
+
+void UniformBuffer::setData(const void* data) const {
+    glBindBuffer(GL_UNIFORM_BUFFER, _id);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<long long>(_size), data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_UNIFORM_HPP
+#define NIHILO_UNIFORM_HPP
+
+/**
+ * Buffer backing a uniform block, bound once to a binding point shared by every program declaring the block.
+ */
+class UniformBuffer {
+
+    public:
+
+    /**
+     * @param binding The binding point, see Shader::bindBlock
+     * @param size The size of the block in bytes, following the std140 layout
+     */
+    UniformBuffer(unsigned int binding, unsigned long long size);
+
+    ~UniformBuffer();
+
+    UniformBuffer(const UniformBuffer&) = delete;
+
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    /**
+     * Replaces the whole content of the block.
+     * @param data The data, of the size of the block
+     */
+    void setData(const void* data) const;
+
+    private:
+
+    unsigned int _id;
+    unsigned long long _size;
+};
+
+#endif //NIHILO_UNIFORM_HPP
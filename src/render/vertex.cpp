@@ -50,10 +50,35 @@ void VertexAttributes::setByte(const unsigned int index, const int size, const i
     glEnableVertexAttribArray(index);
 }
 
+void VertexAttributes::setUnsignedInt(const unsigned int index, const int size, const int stride, const int offset) {
+    glVertexAttribIPointer(index, size, GL_UNSIGNED_INT, stride, reinterpret_cast<void *>(offset));
+    glEnableVertexAttribArray(index);
+}
+
+void VertexAttributes::disable(const unsigned int index) {
+    glDisableVertexAttribArray(index);
+}
+
+void VertexAttributes::setDivisor(const unsigned int index, const unsigned int divisor) {
+    glVertexAttribDivisor(index, divisor);
+}
+
 void VertexAttributes::draw(const unsigned int mode, const unsigned long long size) {
     glDrawArrays(mode, 0, static_cast<int>(size));
 }
 
+void VertexAttributes::multiDraw(const unsigned int mode, const std::vector<int>& firsts, const std::vector<int>& counts) {
+    glMultiDrawArrays(mode, firsts.data(), counts.data(), static_cast<int>(firsts.size()));
+}
+
+void VertexAttributes::drawInstanced(const unsigned int mode, const unsigned long long size, const unsigned long long instances) {
+    glDrawArraysInstanced(mode, 0, static_cast<int>(size), static_cast<int>(instances));
+}
+
+void VertexAttributes::drawIndexed(const unsigned int mode, const unsigned long long size) {
+    glDrawElements(mode, static_cast<int>(size), GL_UNSIGNED_INT, nullptr);
+}
+
 VertexBuffer::VertexBuffer() : _id(0) {
     glGenBuffers(1, &_id);
 }
@@ -70,6 +95,20 @@ void VertexBuffer::clearUse() {
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
+void VertexBuffer::useIndices() const {
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _id);
+}
+
 void VertexBuffer::setData(const unsigned long long size, const void* data, const unsigned int usage) {
     glBufferData(GL_ARRAY_BUFFER, static_cast<long long>(size), data, usage);
 }
+
+void VertexBuffer::setSubData(const unsigned long long offset, const unsigned long long size, const void* data) {
+    glBufferSubData(GL_ARRAY_BUFFER, static_cast<long long>(offset), static_cast<long long>(size), data);
+}
+
+void VertexBuffer::copyFrom(const unsigned long long offset, const unsigned long long size, const unsigned long long destination) const {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, _id);
+    glCopyBufferSubData(GL_ARRAY_BUFFER, GL_COPY_WRITE_BUFFER, static_cast<long long>(offset), static_cast<long long>(destination), static_cast<long long>(size));
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
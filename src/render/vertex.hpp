@@ -40,8 +40,23 @@ class VertexAttributes {
 
     static void setByte(unsigned int index, int size, int stride, int offset);
 
+    static void setUnsignedInt(unsigned int index, int size, int stride, int offset);
+
+    static void disable(unsigned int index);
+
+    static void setDivisor(unsigned int index, unsigned int divisor);
+
     static void draw(unsigned int mode, unsigned long long size);
 
+    static void multiDraw(unsigned int mode, const std::vector<int>& firsts, const std::vector<int>& counts);
+
+    static void drawInstanced(unsigned int mode, unsigned long long size, unsigned long long instances);
+
+    /**
+     * Draws the vertices designated by the unsigned int indices of the index buffer attached to these attributes.
+     */
+    static void drawIndexed(unsigned int mode, unsigned long long size);
+
     private:
 
     unsigned int _id;
@@ -59,13 +74,25 @@ class VertexBuffer {
 
     static void clearUse();
 
+    /**
+     * Attaches the buffer as the index buffer of the vertex attributes in use.
+     */
+    void useIndices() const;
+
     static void setData(unsigned long long size, const void* data, unsigned int usage);
 
+    /**
+     * Copies data from the buffer in use to this buffer, at its start unless a destination offset is given.
+     */
+    void copyFrom(unsigned long long offset, unsigned long long size, unsigned long long destination = 0) const;
+
     template<typename T>
     static void setData(const std::vector<T>& data, const unsigned int usage) {
         setData(sizeof(T) * data.size(), &data[0], usage);
     }
 
+    static void setSubData(unsigned long long offset, unsigned long long size, const void* data);
+
     private:
 
     unsigned int _id;
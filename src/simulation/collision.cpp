@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "collision.hpp"
+
+#include <algorithm>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/norm.hpp"
+
+size_t Collider::detect(const std::vector<Particle>& particles, const size_t index) {
+    _collisions.clear();
+
+    const auto count = static_cast<unsigned int>(particles.size());
+    _positions.resize(count);
+
+    double maxRadius = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        _positions[i] = particles[i].state[index].position;
+        maxRadius = std::max(maxRadius, particles[i].physicalRadius);
+    }
+
+    if (maxRadius <= 0) {
+        return 0;
+    }
+
+    _hash.build(_positions, maxRadius * 2);
+
+    for (unsigned int i = 0; i < count; i++) {
+        const glm::dvec3& position = _positions[i];
+        const double radius = particles[i].physicalRadius;
+        _hash.forEachCandidate(position, [&](const unsigned int j) {
+            if (j <= i) {
+                return;
+            }
+            const double distance = radius + particles[j].physicalRadius;
+            if (glm::length2(_positions[j] - position) < distance * distance) {
+                _collisions.push_back({i, j});
+            }
+        });
+    }
+
+    return _collisions.size();
+}
+
+size_t Collider::merge(std::vector<Particle>& particles, const size_t index, const RadiusScale radiusScale) {
+    if (_collisions.empty()) {
+        return 0;
+    }
+
+    const auto count = static_cast<unsigned int>(particles.size());
+    _parents.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        _parents[i] = i;
+    }
+
+    // union-find, the lowest index of each group is its root
+    for (const auto& [first, second] : _collisions) {
+        const unsigned int a = find(first), b = find(second);
+        if (a < b) {
+            _parents[b] = a;
+        } else if (b < a) {
+            _parents[a] = b;
+        }
+    }
+
+    for (unsigned int i = 0; i < count; i++) {
+        const unsigned int root = find(i);
+        if (root == i) {
+            continue;
+        }
+
+        Particle& target = particles[root];
+        const Particle& source = particles[i];
+        ParticleState& targetState = target.state[index];
+        const ParticleState& sourceState = source.state[index];
+
+        const double mass = target.mass + source.mass;
+        const double targetWeight = target.mass / mass, sourceWeight = source.mass / mass;
+
+        targetState.position = targetState.position * targetWeight + sourceState.position * sourceWeight;
+        targetState.speed = targetState.speed * targetWeight + sourceState.speed * sourceWeight;
+        targetState.acceleration = targetState.acceleration * targetWeight + sourceState.acceleration * sourceWeight;
+
+        // physical volumes add up, the render radius is not linear in the physical one and is mapped again
+        target.physicalRadius = std::cbrt(std::pow(target.physicalRadius, 3) + std::pow(source.physicalRadius, 3));
+        target.radius = radiusScale(target.physicalRadius);
+        target.color = target.color * static_cast<float>(targetWeight) + source.color * static_cast<float>(sourceWeight);
+        target.mass = mass;
+    }
+
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < count; i++) {
+        if (_parents[i] == i) {
+            if (kept != i) {
+                particles[kept] = particles[i];
+            }
+            kept++;
+        }
+    }
+    particles.resize(kept);
+
+    _collisions.clear();
+    return count - kept;
+}
+
+const std::vector<Collision>& Collider::getCollisions() const {
+    return _collisions;
+}
+
+unsigned int Collider::find(unsigned int particle) {
+    while (_parents[particle] != particle) {
+        _parents[particle] = _parents[_parents[particle]];
+        particle = _parents[particle];
+    }
+    return particle;
+}
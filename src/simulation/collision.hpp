@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_COLLISION_HPP
+#define NIHILO_COLLISION_HPP
+
+#include <vector>
+
+#include "grid.hpp"
+#include "simulation.hpp"
+
+enum class CollisionMode {
+    /**
+     * Collisions are ignored.
+     */
+    NONE,
+    /**
+     * Collisions are detected and reported but particles are left untouched.
+     */
+    FLAG,
+    /**
+     * Colliding particles are merged into a single particle.
+     */
+    MERGE
+};
+
+struct Collision {
+    unsigned int first, second;
+};
+
+/**
+ * Detects pairs of particles closer than the sum of their physical radius.
+ *
+ * Particles are binned in a spatial hash whose cells are sized after the largest radius,
+ * so that detection only tests particles of adjacent cells and is linear in the number of particles.
+ */
+class Collider {
+    public:
+
+    /**
+     * Finds every overlapping pair of particles.
+     *
+     * @param particles The particles.
+     * @param index The index of the state to test.
+     * @return The number of collisions found.
+     */
+    size_t detect(const std::vector<Particle>& particles, size_t index);
+
+    /**
+     * Merges the particles of every collision found by the last detection.
+     * Groups of particles connected by collisions are merged together.
+     * Mass, momentum and physical volume are conserved, the merged particle is placed at the center of mass.
+     *
+     * @param particles The particles, absorbed ones are removed.
+     * @param index The index of the state to merge.
+     * @param radiusScale The mapping giving the render radius of merged particles from their physical radius.
+     * @return The number of removed particles.
+     */
+    size_t merge(std::vector<Particle>& particles, size_t index, RadiusScale radiusScale);
+
+    [[nodiscard]] const std::vector<Collision>& getCollisions() const;
+
+    private:
+
+    unsigned int find(unsigned int particle);
+
+    SpatialHash _hash;
+    std::vector<glm::dvec3> _positions;
+    std::vector<Collision> _collisions;
+    std::vector<unsigned int> _parents;
+};
+
+#endif //NIHILO_COLLISION_HPP
@@ -25,9 +25,6 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/gtx/norm.hpp"
 
-// gravitational constant in SI unit
-constexpr double G = 6.67430e-11;
-
 glm::dvec3 gravity(const double mass1, const double mass2, const glm::dvec3& position1, const glm::dvec3& position2, const double softSq) {
     const glm::dvec3 delta = position2 - position1;
     const double length2 = glm::length2(delta);
@@ -36,3 +33,14 @@ glm::dvec3 gravity(const double mass1, const double mass2, const glm::dvec3& pos
     }
     return delta * (G * mass1 * mass2 / ((length2 + softSq) * std::sqrt(length2)));
 }
+
+double nearFraction(const double distance, const double inner, const double outer) {
+    if (distance <= inner) {
+        return 1;
+    }
+    if (distance >= outer) {
+        return 0;
+    }
+    const double x = (distance - inner) / (outer - inner);
+    return 1 - x * x * (3 - 2 * x);
+}
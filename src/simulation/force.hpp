@@ -25,6 +25,9 @@
 
 #include "glm/glm.hpp"
 
+// gravitational constant in SI unit
+constexpr double G = 6.67430e-11;
+
 /**
  * Computes the gravitational force exerted by particle 2 on particle 1.
  *
@@ -40,4 +43,18 @@
  */
 glm::dvec3 gravity(double mass1, double mass2, const glm::dvec3& position1, const glm::dvec3& position2, double softSq);
 
+/**
+ * Computes the fraction of a pair interaction attributed to the near field when splitting forces.
+ * The far field receives the remaining fraction so that both parts always sum to the whole interaction.
+ *
+ * The fraction smoothly decreases from 1 at the inner radius to 0 at the outer radius,
+ * avoiding the energy errors caused by a sharp cutoff.
+ *
+ * @param distance Distance between the particles
+ * @param inner Radius below which the interaction is fully near
+ * @param outer Radius above which the interaction is fully far
+ * @return The near fraction, between 0 and 1
+ */
+double nearFraction(double distance, double inner, double outer);
+
 #endif //NIHILO_FORCE_HPP
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "grid.hpp"
+
+#include <algorithm>
+#include <bit>
+
+// cell coordinates are clamped well inside the 64 bits range, so that ejected particles and their adjacent cells never overflow
+constexpr double CELL_LIMIT = 0x1p62;
+
+void SpatialHash::build(const std::vector<glm::dvec3>& positions, const double cellSize) {
+    _cellSize = cellSize;
+    _inverseCellSize = 1.0 / cellSize;
+
+    const auto count = static_cast<unsigned int>(positions.size());
+    const unsigned int tableSize = std::bit_ceil(std::max(count * 2, 2u));
+    _mask = tableSize - 1;
+
+    // counting sort of the particles by bucket
+    _bucketStart.assign(tableSize + 1, 0);
+    _buckets.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        const unsigned int b = bucket(cell(positions[i]));
+        _buckets[i] = b;
+        _bucketStart[b + 1]++;
+    }
+
+    for (unsigned int b = 0; b < tableSize; b++) {
+        _bucketStart[b + 1] += _bucketStart[b];
+    }
+
+    _cursor.assign(_bucketStart.begin(), _bucketStart.end() - 1);
+    _particles.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        _particles[_cursor[_buckets[i]]++] = i;
+    }
+}
+
+double SpatialHash::getCellSize() const {
+    return _cellSize;
+}
+
+glm::i64vec3 SpatialHash::cell(const glm::dvec3& position) const {
+    return glm::i64vec3(glm::clamp(glm::floor(position * _inverseCellSize), -CELL_LIMIT, CELL_LIMIT));
+}
+
+unsigned int SpatialHash::bucket(const glm::i64vec3& cell) const {
+    // https://matthias-research.github.io/pages/publications/tetraederCollision.pdf
+    const unsigned long long hash = static_cast<unsigned long long>(cell.x) * 73856093ull
+                                  ^ static_cast<unsigned long long>(cell.y) * 19349663ull
+                                  ^ static_cast<unsigned long long>(cell.z) * 83492791ull;
+    return static_cast<unsigned int>(hash ^ hash >> 32) & _mask;
+}
+
+unsigned int SpatialHash::adjacentBuckets(const glm::dvec3& position, unsigned int (&buckets)[27]) const {
+    if (_particles.empty()) {
+        return 0;
+    }
+
+    const glm::i64vec3 center = cell(position);
+    unsigned int count = 0;
+    for (int x = -1; x <= 1; x++) {
+        for (int y = -1; y <= 1; y++) {
+            for (int z = -1; z <= 1; z++) {
+                buckets[count++] = bucket(center + glm::i64vec3(x, y, z));
+            }
+        }
+    }
+
+    // adjacent cells may collide in the table, each bucket must be visited only once
+    std::sort(buckets, buckets + count);
+    return std::unique(buckets, buckets + count) - buckets;
+}
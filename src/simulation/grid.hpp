@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_GRID_HPP
+#define NIHILO_GRID_HPP
+
+#include <vector>
+
+#include "glm/glm.hpp"
+#include "glm/ext/vector_int3_sized.hpp"
+
+/**
+ * Uniform grid of cubic cells in which particles are binned.
+ *
+ * Cells are not stored explicitly: their integer coordinates are hashed into a table sized after the number of particles,
+ * so the grid covers an unbounded space with memory linear in the particle count.
+ * The content of the table is stored in CSR format: particles of bucket b are in range [start(b), start(b + 1)).
+ * Different cells may share a bucket, callers must therefore filter candidates by distance.
+ */
+class SpatialHash {
+    public:
+
+    /**
+     * Bins the given positions in cells of the given size.
+     * Internal buffers are reused between builds.
+     *
+     * @param positions The positions of the particles.
+     * @param cellSize The edge length of a cell.
+     */
+    void build(const std::vector<glm::dvec3>& positions, double cellSize);
+
+    /**
+     * Calls the given function with the index of every particle binned in the cell containing the given position
+     * or in one of its 26 adjacent cells.
+     * When the cell size is greater than a distance d, this visits every particle closer than d to the position.
+     *
+     * @param position The position.
+     * @param function The function to call with each candidate index.
+     */
+    template<typename F>
+    void forEachCandidate(const glm::dvec3& position, F&& function) const {
+        unsigned int buckets[27];
+        const unsigned int count = adjacentBuckets(position, buckets);
+        for (unsigned int i = 0; i < count; i++) {
+            const unsigned int bucket = buckets[i];
+            for (unsigned int k = _bucketStart[bucket], end = _bucketStart[bucket + 1]; k < end; k++) {
+                function(_particles[k]);
+            }
+        }
+    }
+
+    [[nodiscard]] double getCellSize() const;
+
+    private:
+
+    [[nodiscard]] glm::i64vec3 cell(const glm::dvec3& position) const;
+
+    [[nodiscard]] unsigned int bucket(const glm::i64vec3& cell) const;
+
+    unsigned int adjacentBuckets(const glm::dvec3& position, unsigned int (&buckets)[27]) const;
+
+    double _cellSize{1}, _inverseCellSize{1};
+    unsigned int _mask{};
+    std::vector<unsigned int> _bucketStart, _cursor, _buckets, _particles;
+};
+
+#endif //NIHILO_GRID_HPP
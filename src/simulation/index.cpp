@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "index.hpp"
+
+#include <algorithm>
+
+constexpr unsigned int GRID_SIZE = 16; // cells per axis
+constexpr unsigned int REFRESH_PERIOD = 64; // updates between rebuilds
+
+CellIndex::CellIndex() : _generation(0), _age(0), _valid(false) {
+}
+
+bool CellIndex::update(const std::vector<Particle>& particles, const size_t index, const unsigned long long generation) {
+    if (_valid && _generation == generation && ++_age < REFRESH_PERIOD) {
+        return false;
+    }
+    rebuild(particles, index);
+    _generation = generation;
+    _age = 0;
+    _valid = true;
+    return true;
+}
+
+const std::vector<unsigned int>& CellIndex::getOrder() const {
+    return _order;
+}
+
+const std::vector<unsigned int>& CellIndex::getCellStarts() const {
+    return _cellStarts;
+}
+
+void CellIndex::rebuild(const std::vector<Particle>& particles, const size_t index) {
+    const size_t count = particles.size();
+    _order.resize(count);
+    _cells.resize(count);
+    _cellStarts.clear();
+    if (count == 0) {
+        _cellStarts.push_back(0);
+        return;
+    }
+
+    glm::dvec3 min = particles[0].state[index].position, max = min;
+    for (const Particle& particle : particles) {
+        min = glm::min(min, particle.state[index].position);
+        max = glm::max(max, particle.state[index].position);
+    }
+    const glm::dvec3 scale = static_cast<double>(GRID_SIZE) / glm::max(max - min, glm::dvec3(1));
+
+    // counting sort of the particles by cell
+    _cursor.assign(GRID_SIZE * GRID_SIZE * GRID_SIZE + 1, 0);
+    for (size_t i = 0; i < count; i++) {
+        const glm::uvec3 cell = glm::min(glm::uvec3((particles[i].state[index].position - min) * scale), glm::uvec3(GRID_SIZE - 1));
+        _cells[i] = (cell.z * GRID_SIZE + cell.y) * GRID_SIZE + cell.x;
+        _cursor[_cells[i] + 1]++;
+    }
+
+    for (size_t c = 1; c < _cursor.size(); c++) {
+        if (_cursor[c] != 0) {
+            _cellStarts.push_back(_cursor[c - 1]);
+        }
+        _cursor[c] += _cursor[c - 1];
+    }
+    _cellStarts.push_back(static_cast<unsigned int>(count));
+
+    for (size_t i = 0; i < count; i++) {
+        _order[_cursor[_cells[i]]++] = static_cast<unsigned int>(i);
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_INDEX_HPP
+#define NIHILO_INDEX_HPP
+
+#include <vector>
+
+#include "simulation.hpp"
+
+/**
+ * Coarse uniform grid over the bounding box of the particles, used to order snapshots so that
+ * the particles of each cell are contiguous and can be culled or aggregated together by the renderer.
+ *
+ * The order is rebuilt when particles change and periodically, so that cells stay compact as particles move.
+ * A periodic rebuild only permutes the same particles: snapshots carry the order so the renderer can follow them.
+ * In between, particles drift out of their cell: users must compute the bounds of each cell from its members
+ * rather than from the grid.
+ */
+class CellIndex {
+    public:
+
+    CellIndex();
+
+    /**
+     * Rebuilds the order if the particles changed or if it is too old.
+     *
+     * @param particles The particles.
+     * @param index The index of the state to use.
+     * @param generation The generation of the particles.
+     * @return Whether the order was rebuilt.
+     */
+    bool update(const std::vector<Particle>& particles, size_t index, unsigned long long generation);
+
+    /**
+     * @return The particle indices in snapshot order.
+     */
+    [[nodiscard]] const std::vector<unsigned int>& getOrder() const;
+
+    /**
+     * Cells without particles are skipped, particles of cell c are in range [start(c), start(c + 1)) of the order.
+     *
+     * @return The start of each non-empty cell, followed by the particle count.
+     */
+    [[nodiscard]] const std::vector<unsigned int>& getCellStarts() const;
+
+    private:
+
+    void rebuild(const std::vector<Particle>& particles, size_t index);
+
+    std::vector<unsigned int> _order, _cellStarts, _cells, _cursor;
+    unsigned long long _generation;
+    unsigned int _age;
+    bool _valid;
+};
+
+#endif //NIHILO_INDEX_HPP
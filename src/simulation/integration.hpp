@@ -32,6 +32,32 @@
  */
 typedef std::function<glm::dvec3(const ParticleState&)> Accelerator;
 
+/**
+ * Computes the next state of a given particle.
+ */
+typedef void (*Integration)(const ParticleState& current, ParticleState& next, double timeStep, const Accelerator& accelerator);
+
+enum class Integrator {
+    /**
+     * Each particle is integrated using the Euler method.
+     */
+    EULER,
+    /**
+     * Each particle is integrated using the velocity Verlet method.
+     */
+    VERLET,
+    /**
+     * The system is integrated using multiple time stepping (RESPA).
+     *
+     * Forces are split into a near field, integrated with velocity Verlet over several substeps,
+     * and a far field, applied as a kick at both ends of the step and evaluated once per step.
+     * See <a href="https://doi.org/10.1063/1.463137">Tuckerman et al. 1992</a>.
+     *
+     * Like velocity Verlet, it is only compatible with acceleration formula independent of speed.
+     */
+    MULTI_RATE
+};
+
 /**
  * Computes the next state of the given particle using the Euler method.
  *
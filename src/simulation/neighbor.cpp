@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "neighbor.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/norm.hpp"
+
+NeighborList::NeighborList(const double cutoff, const double skin) : _cutoff(), _skin(), _invalid(true), _offsets(1, 0) {
+    setCutoff(cutoff);
+    setSkin(skin);
+}
+
+bool NeighborList::update(const std::vector<glm::dvec3>& positions) {
+    if (!_invalid && positions.size() == _reference.size()) {
+        double maxDisplacement2 = 0;
+        for (size_t i = 0; i < positions.size(); i++) {
+            maxDisplacement2 = std::max(maxDisplacement2, glm::length2(positions[i] - _reference[i]));
+        }
+
+        const double halfSkin = _skin * 0.5;
+        if (maxDisplacement2 <= halfSkin * halfSkin) {
+            return false;
+        }
+    }
+
+    rebuild(positions);
+    return true;
+}
+
+void NeighborList::rebuild(const std::vector<glm::dvec3>& positions) {
+    const double range = _cutoff + _skin;
+    const double range2 = range * range;
+
+    _hash.build(positions, range);
+
+    const auto count = static_cast<unsigned int>(positions.size());
+    _offsets.resize(count + 1);
+    _indices.clear();
+
+    for (unsigned int i = 0; i < count; i++) {
+        _offsets[i] = static_cast<unsigned int>(_indices.size());
+
+        const glm::dvec3& position = positions[i];
+        _hash.forEachCandidate(position, [&](const unsigned int j) {
+            if (j != i && glm::length2(positions[j] - position) <= range2) {
+                _indices.push_back(j);
+            }
+        });
+    }
+    _offsets[count] = static_cast<unsigned int>(_indices.size());
+
+    _reference = positions;
+    _invalid = false;
+}
+
+std::span<const unsigned int> NeighborList::get(const size_t particle) const {
+    return {_indices.data() + _offsets[particle], _offsets[particle + 1] - _offsets[particle]};
+}
+
+const std::vector<unsigned int>& NeighborList::getOffsets() const {
+    return _offsets;
+}
+
+const std::vector<unsigned int>& NeighborList::getIndices() const {
+    return _indices;
+}
+
+double NeighborList::getCutoff() const {
+    return _cutoff;
+}
+
+void NeighborList::setCutoff(const double cutoff) {
+    if (cutoff <= 0) {
+        throw std::domain_error("Cutoff must be greater than zero");
+    }
+    _cutoff = cutoff;
+    _invalid = true;
+}
+
+double NeighborList::getSkin() const {
+    return _skin;
+}
+
+void NeighborList::setSkin(const double skin) {
+    if (skin < 0) {
+        throw std::domain_error("Skin must be positive");
+    }
+    _skin = skin;
+    _invalid = true;
+}
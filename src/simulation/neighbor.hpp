@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_NEIGHBOR_HPP
+#define NIHILO_NEIGHBOR_HPP
+
+#include <span>
+#include <vector>
+
+#include "grid.hpp"
+#include "glm/glm.hpp"
+
+/**
+ * Verlet neighbor list for short-range interactions.
+ *
+ * The list contains, for each particle, every other particle closer than the cutoff radius plus a skin.
+ * As long as no particle moved by more than half the skin since the last build,
+ * every pair closer than the cutoff is guaranteed to be in the list and the list does not need to be rebuilt.
+ * See <a href="https://en.wikipedia.org/wiki/Verlet_list">Wikipedia</a>.
+ *
+ * Neighbors are stored in CSR format: neighbors of particle i are indices[offsets[i]..offsets[i + 1]).
+ * Each pair is stored in both directions so that the traversal of a particle only writes to that particle.
+ */
+class NeighborList {
+    public:
+
+    NeighborList(double cutoff, double skin);
+
+    /**
+     * Rebuilds the list if a particle moved by more than half the skin or if the number of particles changed.
+     *
+     * @param positions The current positions of the particles.
+     * @return Whether the list was rebuilt.
+     */
+    bool update(const std::vector<glm::dvec3>& positions);
+
+    /**
+     * Unconditionally rebuilds the list.
+     *
+     * @param positions The current positions of the particles.
+     */
+    void rebuild(const std::vector<glm::dvec3>& positions);
+
+    [[nodiscard]] std::span<const unsigned int> get(size_t particle) const;
+
+    [[nodiscard]] const std::vector<unsigned int>& getOffsets() const;
+
+    [[nodiscard]] const std::vector<unsigned int>& getIndices() const;
+
+    [[nodiscard]] double getCutoff() const;
+
+    void setCutoff(double cutoff);
+
+    [[nodiscard]] double getSkin() const;
+
+    void setSkin(double skin);
+
+    private:
+
+    double _cutoff, _skin;
+    bool _invalid;
+    SpatialHash _hash;
+    std::vector<glm::dvec3> _reference;
+    std::vector<unsigned int> _offsets, _indices;
+};
+
+#endif //NIHILO_NEIGHBOR_HPP
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "potential.hpp"
+
+#include "force.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/norm.hpp"
+
+Potential pointMassPotential(const glm::dvec3& center, const double mass) {
+    return {PotentialType::POINT_MASS, center, G * mass, 0, 0};
+}
+
+Potential plummerPotential(const glm::dvec3& center, const double mass, const double radius) {
+    return {PotentialType::PLUMMER, center, G * mass, radius * radius, 0};
+}
+
+Potential nfwPotential(const glm::dvec3& center, const double mass, const double scaleRadius) {
+    return {PotentialType::NFW, center, G * mass, scaleRadius, 0};
+}
+
+Potential miyamotoNagaiPotential(const glm::dvec3& center, const double mass, const double radialScale, const double verticalScale) {
+    return {PotentialType::MIYAMOTO_NAGAI, center, G * mass, radialScale, verticalScale * verticalScale};
+}
+
+Potential logarithmicPotential(const glm::dvec3& center, const double speed, const double coreRadius, const double flattening) {
+    return {PotentialType::LOGARITHMIC, center, speed * speed, coreRadius * coreRadius, 1 / (flattening * flattening)};
+}
+
+// Each function takes the position relative to the center of the potential.
+// For a given type, a and b hold the values precomputed by the factory functions above.
+
+inline glm::dvec3 pointMassAcceleration(const double strength, const glm::dvec3& delta) {
+    const double r2 = glm::length2(delta);
+    if (r2 < glm::epsilon<double>()) {
+        return {0, 0, 0};
+    }
+    return delta * (-strength / (r2 * std::sqrt(r2)));
+}
+
+inline glm::dvec3 plummerAcceleration(const double strength, const double a2, const glm::dvec3& delta) {
+    const double d2 = glm::length2(delta) + a2;
+    return delta * (-strength / (d2 * std::sqrt(d2)));
+}
+
+inline glm::dvec3 nfwAcceleration(const double strength, const double scaleRadius, const glm::dvec3& delta) {
+    const double r2 = glm::length2(delta);
+    if (r2 < glm::epsilon<double>()) {
+        return {0, 0, 0};
+    }
+    const double r = std::sqrt(r2);
+    const double x = r / scaleRadius;
+    // mass enclosed within r, relative to the characteristic mass
+    const double enclosed = std::log1p(x) - x / (1 + x);
+    return delta * (-strength * enclosed / (r2 * r));
+}
+
+inline glm::dvec3 miyamotoNagaiAcceleration(const double strength, const double a, const double b2, const glm::dvec3& delta) {
+    const double zb = std::sqrt(delta.z * delta.z + b2);
+    const double azb = a + zb;
+    const double d2 = delta.x * delta.x + delta.y * delta.y + azb * azb;
+    const double f = -strength / (d2 * std::sqrt(d2));
+    return {delta.x * f, delta.y * f, delta.z * f * azb / zb};
+}
+
+inline glm::dvec3 logarithmicAcceleration(const double strength, const double core2, const double inverseFlattening2, const glm::dvec3& delta) {
+    const double z2 = delta.z * inverseFlattening2;
+    const double f = -strength / (core2 + delta.x * delta.x + delta.y * delta.y + delta.z * z2);
+    return {delta.x * f, delta.y * f, z2 * f};
+}
+
+glm::dvec3 potentialAcceleration(const std::vector<Potential>& potentials, const glm::dvec3& position) {
+    glm::dvec3 acceleration(0);
+    for (const auto& [type, center, strength, a, b] : potentials) {
+        const glm::dvec3 delta = position - center;
+        switch (type) {
+            case PotentialType::POINT_MASS:
+                acceleration += pointMassAcceleration(strength, delta);
+                break;
+            case PotentialType::PLUMMER:
+                acceleration += plummerAcceleration(strength, a, delta);
+                break;
+            case PotentialType::NFW:
+                acceleration += nfwAcceleration(strength, a, delta);
+                break;
+            case PotentialType::MIYAMOTO_NAGAI:
+                acceleration += miyamotoNagaiAcceleration(strength, a, b, delta);
+                break;
+            case PotentialType::LOGARITHMIC:
+                acceleration += logarithmicAcceleration(strength, a, b, delta);
+                break;
+        }
+    }
+    return acceleration;
+}
+
+template<typename F>
+void addAccelerations(const glm::dvec3& center, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations, F&& function) {
+    const size_t count = positions.size();
+    for (size_t i = 0; i < count; i++) {
+        accelerations[i] += function(positions[i] - center);
+    }
+}
+
+void addPotentialAccelerations(const std::vector<Potential>& potentials, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations) {
+    for (const auto& [type, center, strength, a, b] : potentials) {
+        switch (type) {
+            case PotentialType::POINT_MASS:
+                addAccelerations(center, positions, accelerations, [strength](const glm::dvec3& delta) {
+                    return pointMassAcceleration(strength, delta);
+                });
+                break;
+            case PotentialType::PLUMMER:
+                addAccelerations(center, positions, accelerations, [strength, a](const glm::dvec3& delta) {
+                    return plummerAcceleration(strength, a, delta);
+                });
+                break;
+            case PotentialType::NFW:
+                addAccelerations(center, positions, accelerations, [strength, a](const glm::dvec3& delta) {
+                    return nfwAcceleration(strength, a, delta);
+                });
+                break;
+            case PotentialType::MIYAMOTO_NAGAI:
+                addAccelerations(center, positions, accelerations, [strength, a, b](const glm::dvec3& delta) {
+                    return miyamotoNagaiAcceleration(strength, a, b, delta);
+                });
+                break;
+            case PotentialType::LOGARITHMIC:
+                addAccelerations(center, positions, accelerations, [strength, a, b](const glm::dvec3& delta) {
+                    return logarithmicAcceleration(strength, a, b, delta);
+                });
+                break;
+        }
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_POTENTIAL_HPP
+#define NIHILO_POTENTIAL_HPP
+
+#include <vector>
+
+#include "glm/glm.hpp"
+
+enum class PotentialType {
+    /**
+     * Point mass, see <a href="https://en.wikipedia.org/wiki/Gravitational_potential">Wikipedia</a>.
+     */
+    POINT_MASS,
+    /**
+     * Plummer sphere, see <a href="https://en.wikipedia.org/wiki/Plummer_model">Wikipedia</a>.
+     */
+    PLUMMER,
+    /**
+     * Navarro-Frenk-White dark matter halo, see <a href="https://en.wikipedia.org/wiki/Navarro%E2%80%93Frenk%E2%80%93White_profile">Wikipedia</a>.
+     */
+    NFW,
+    /**
+     * Miyamoto-Nagai disk lying in the XY plane, see <a href="https://doi.org/10.1093/pasj/27.4.533">Miyamoto & Nagai 1975</a>.
+     */
+    MIYAMOTO_NAGAI,
+    /**
+     * Flattened logarithmic halo with a flat rotation curve, see Binney & Tremaine, Galactic Dynamics, §2.3.2.
+     */
+    LOGARITHMIC
+};
+
+/**
+ * Analytic external gravitational field, replacing a smooth background mass distribution.
+ * Use the factory functions below rather than filling the parameters manually.
+ */
+struct Potential {
+    PotentialType type;
+    glm::dvec3 center;
+    double strength; // G * mass, or squared circular speed for logarithmic potentials
+    double a, b; // scale lengths or flattening, depending on the type
+};
+
+/**
+ * @param center Position of the mass
+ * @param mass Mass in kg
+ */
+Potential pointMassPotential(const glm::dvec3& center, double mass);
+
+/**
+ * @param center Center of the sphere
+ * @param mass Total mass in kg
+ * @param radius Plummer radius in m
+ */
+Potential plummerPotential(const glm::dvec3& center, double mass, double radius);
+
+/**
+ * @param center Center of the halo
+ * @param mass Characteristic mass 4π ρ0 rs³ in kg
+ * @param scaleRadius Scale radius rs in m
+ */
+Potential nfwPotential(const glm::dvec3& center, double mass, double scaleRadius);
+
+/**
+ * @param center Center of the disk
+ * @param mass Total mass in kg
+ * @param radialScale Radial scale length a in m
+ * @param verticalScale Vertical scale height b in m
+ */
+Potential miyamotoNagaiPotential(const glm::dvec3& center, double mass, double radialScale, double verticalScale);
+
+/**
+ * @param center Center of the halo
+ * @param speed Asymptotic circular speed in m/s
+ * @param coreRadius Core radius in m
+ * @param flattening Axis ratio of the equipotentials along Z
+ */
+Potential logarithmicPotential(const glm::dvec3& center, double speed, double coreRadius, double flattening);
+
+/**
+ * Computes the acceleration induced by the given potentials at a single position.
+ *
+ * @param potentials The potentials
+ * @param position The position
+ * @return The acceleration
+ */
+glm::dvec3 potentialAcceleration(const std::vector<Potential>& potentials, const glm::dvec3& position);
+
+/**
+ * Adds the acceleration induced by the given potentials to every particle.
+ *
+ * The type dispatch is hoisted out of the particle loop, so that each potential is applied with a tight loop over positions.
+ *
+ * @param potentials The potentials
+ * @param positions The positions of the particles
+ * @param accelerations The accelerations of the particles, incremented
+ */
+void addPotentialAccelerations(const std::vector<Potential>& potentials, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations);
+
+#endif //NIHILO_POTENTIAL_HPP
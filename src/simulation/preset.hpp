@@ -23,6 +23,9 @@
 #ifndef NIHILO_PRESET_HPP
 #define NIHILO_PRESET_HPP
 
+#include <vector>
+
+#include "potential.hpp"
 #include "simulation.hpp"
 
 constexpr size_t SOLAR_SYSTEM_SIZE = 9;
@@ -31,17 +34,21 @@ inline float scaleSolarSystemBody(const double original) {
     return static_cast<float>(std::log10(original) - 6) * 0.1f;
 }
 
+inline ParticleInfo solarSystemBody(const double mass, const double radius, const glm::vec3& color) {
+    return {mass, radius, scaleSolarSystemBody(radius), color};
+}
+
 // Mass and radius from https://ssd.jpl.nasa.gov/planets/phys_par.html
 const ParticleInfo SOLAR_SYSTEM_INFO[SOLAR_SYSTEM_SIZE] = {
-    {1.9884e30, scaleSolarSystemBody(696340e3), glm::vec3(1.0, 1.0, 1.0)}, // Sun
-    {0.330103e24, scaleSolarSystemBody(2439.4e3), glm::vec3(0.59, 0.59, 0.59)}, // Mercury
-    {4.86731e24, scaleSolarSystemBody(6051.8e3), glm::vec3(0.91, 0.83, 0.63)}, // Venus
-    {5.97217e24, scaleSolarSystemBody(6371.0084e3), glm::vec3(0.24, 0.47, 0.87)}, // Earth
-    {0.641691e24, scaleSolarSystemBody(3389.5e3), glm::vec3(0.78, 0.39, 0.20)}, // Mars
-    {1898.125e24, scaleSolarSystemBody(69911e3), glm::vec3(0.86, 0.71, 0.55)}, // Jupiter
-    {568.317e24, scaleSolarSystemBody(58232e3), glm::vec3(0.91, 0.83, 0.67)}, // Saturn
-    {86.8099e24, scaleSolarSystemBody(25362e3), glm::vec3(0.63, 0.78, 0.87)}, // Uranus
-    {102.4092e24, scaleSolarSystemBody(24622e3), glm::vec3(0.31, 0.47, 0.78)} // Neptune
+    solarSystemBody(1.9884e30, 696340e3, glm::vec3(1.0, 1.0, 1.0)), // Sun
+    solarSystemBody(0.330103e24, 2439.4e3, glm::vec3(0.59, 0.59, 0.59)), // Mercury
+    solarSystemBody(4.86731e24, 6051.8e3, glm::vec3(0.91, 0.83, 0.63)), // Venus
+    solarSystemBody(5.97217e24, 6371.0084e3, glm::vec3(0.24, 0.47, 0.87)), // Earth
+    solarSystemBody(0.641691e24, 3389.5e3, glm::vec3(0.78, 0.39, 0.20)), // Mars
+    solarSystemBody(1898.125e24, 69911e3, glm::vec3(0.86, 0.71, 0.55)), // Jupiter
+    solarSystemBody(568.317e24, 58232e3, glm::vec3(0.91, 0.83, 0.67)), // Saturn
+    solarSystemBody(86.8099e24, 25362e3, glm::vec3(0.63, 0.78, 0.87)), // Uranus
+    solarSystemBody(102.4092e24, 24622e3, glm::vec3(0.31, 0.47, 0.78)) // Neptune
 };
 
 // Generated from https://ssd.jpl.nasa.gov/horizons/
@@ -57,4 +64,29 @@ const ParticleState SOLAR_SYSTEM_INITIAL_STATE[SOLAR_SYSTEM_SIZE] = {
     {glm::dvec3(4292269953779.307, -1279957446129.29, -72568953377.18726), glm::dvec3(1525.496768751638, 5232.244900811973, -142.97590953353745)}
 };
 
+constexpr unsigned int SOLAR_SYSTEM_POTENTIALS = 5;
+
+/**
+ * Background fields around the Sun, far heavier than any real one so that the orbits visibly precess within a few years.
+ *
+ * @param preset The index of the preset, 0 leaves the solar system alone
+ * @return The potentials of the preset
+ */
+inline std::vector<Potential> solarSystemPotentials(const unsigned int preset) {
+    constexpr double mass = 1.9884e30; // of the Sun
+    const glm::dvec3 center(0);
+    switch (preset % SOLAR_SYSTEM_POTENTIALS) {
+        case 1: // diffuse cloud engulfing the planets
+            return {plummerPotential(center, mass * 0.1, 20 * POSITION_SCALE)};
+        case 2: // dark matter halo
+            return {nfwPotential(center, mass * 0.5, 30 * POSITION_SCALE)};
+        case 3: // massive debris disk in the ecliptic
+            return {miyamotoNagaiPotential(center, mass * 0.05, 30 * POSITION_SCALE, POSITION_SCALE)};
+        case 4: // flattened halo with a flat rotation curve
+            return {logarithmicPotential(center, 3e3, 5 * POSITION_SCALE, 0.8)};
+        default:
+            return {};
+    }
+}
+
 #endif //NIHILO_PRESET_HPP
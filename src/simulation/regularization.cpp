@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "regularization.hpp"
+
+#include "glm/gtc/constants.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/norm.hpp"
+
+// regularized steps per orbit, the oscillator is smooth so a few are enough even for very eccentric orbits
+constexpr double STEPS_PER_ORBIT = 64;
+// relative tolerance on the physical time reached at the end of the integration
+constexpr double TIME_TOLERANCE = 1e-12;
+constexpr unsigned int MAX_STEPS = 1 << 16;
+
+struct RegularizedState {
+    glm::dvec4 u, v; // v = du/dτ
+    double h; // Kepler energy per unit reduced mass
+    double t; // physical time
+};
+
+/**
+ * Computes L(u) x, with x extended to 4D by a null component.
+ */
+inline glm::dvec4 multiplyL(const glm::dvec4& u, const glm::dvec4& x) {
+    return {
+        u.x * x.x - u.y * x.y - u.z * x.z + u.w * x.w,
+        u.y * x.x + u.x * x.y - u.w * x.z - u.z * x.w,
+        u.z * x.x + u.w * x.y + u.x * x.z + u.y * x.w,
+        u.w * x.x - u.z * x.y + u.y * x.z - u.x * x.w
+    };
+}
+
+/**
+ * Computes L(u)^T x, with x extended to 4D by a null component.
+ */
+inline glm::dvec4 multiplyLT(const glm::dvec4& u, const glm::dvec3& x) {
+    return {
+        u.x * x.x + u.y * x.y + u.z * x.z,
+        -u.y * x.x + u.x * x.y + u.w * x.z,
+        -u.z * x.x - u.w * x.y + u.x * x.z,
+        u.w * x.x - u.z * x.y + u.y * x.z
+    };
+}
+
+inline glm::dvec3 toPosition(const glm::dvec4& u) {
+    const glm::dvec4 x = multiplyL(u, u);
+    return {x.x, x.y, x.z};
+}
+
+inline glm::dvec4 toRegularized(const glm::dvec3& position) {
+    const double r = glm::length(position);
+    if (position.x >= 0) {
+        const double u1 = std::sqrt(0.5 * (r + position.x));
+        return {u1, position.y / (2 * u1), position.z / (2 * u1), 0};
+    }
+    const double u2 = std::sqrt(0.5 * (r - position.x));
+    return {position.y / (2 * u2), u2, 0, position.z / (2 * u2)};
+}
+
+inline RegularizedState derivative(const RegularizedState& state, const Perturbation& perturbation) {
+    const double r = glm::length2(state.u);
+    const glm::dvec4 lp = multiplyLT(state.u, perturbation(toPosition(state.u)));
+    return {
+        state.v,
+        state.u * (state.h * 0.5) + lp * (r * 0.5),
+        2 * glm::dot(state.v, lp),
+        r
+    };
+}
+
+inline RegularizedState add(const RegularizedState& state, const RegularizedState& delta, const double factor) {
+    return {state.u + delta.u * factor, state.v + delta.v * factor, state.h + delta.h * factor, state.t + delta.t * factor};
+}
+
+inline void stepRungeKutta4(RegularizedState& state, const double step, const Perturbation& perturbation) {
+    const RegularizedState k1 = derivative(state, perturbation);
+    const RegularizedState k2 = derivative(add(state, k1, step * 0.5), perturbation);
+    const RegularizedState k3 = derivative(add(state, k2, step * 0.5), perturbation);
+    const RegularizedState k4 = derivative(add(state, k3, step), perturbation);
+
+    const double sixth = step / 6;
+    state = add(state, k1, sixth);
+    state = add(state, k2, sixth * 2);
+    state = add(state, k3, sixth * 2);
+    state = add(state, k4, sixth);
+}
+
+void advanceRegularized(glm::dvec3& position, glm::dvec3& speed, const double mu, const double duration, const Perturbation& perturbation) {
+    RegularizedState state;
+    state.u = toRegularized(position);
+    state.v = multiplyLT(state.u, speed) * 0.5;
+    state.h = 0.5 * glm::length2(speed) - mu / glm::length(position);
+    state.t = 0;
+
+    const double tolerance = duration * TIME_TOLERANCE;
+    for (unsigned int i = 0; i < MAX_STEPS; i++) {
+        const double remaining = duration - state.t;
+        if (std::abs(remaining) <= tolerance) {
+            break;
+        }
+
+        const double r = glm::length2(state.u);
+        double step;
+        if (state.h < 0) {
+            // the unperturbed oscillator has a pulsation of sqrt(-h / 2) in fictitious time
+            step = glm::two_pi<double>() / (std::sqrt(-0.5 * state.h) * STEPS_PER_ORBIT);
+        } else {
+            // unbound, the motion is not periodic: the physical step follows the local dynamical time
+            step = glm::two_pi<double>() * std::sqrt(r / mu) / STEPS_PER_ORBIT;
+        }
+
+        // last steps, dt = r dτ gives the fictitious time left to reach the end, refined until the tolerance is reached
+        step = std::min(step, remaining / r);
+
+        stepRungeKutta4(state, step, perturbation);
+    }
+
+    position = toPosition(state.u);
+    speed = glm::dvec3(multiplyL(state.u, state.v)) * (2 / glm::length2(state.u));
+}
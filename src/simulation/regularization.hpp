@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_REGULARIZATION_HPP
+#define NIHILO_REGULARIZATION_HPP
+
+#include <functional>
+
+#include "glm/glm.hpp"
+
+/**
+ * Computes the perturbing acceleration of a two-body system, i.e. the relative acceleration not caused by the pair itself,
+ * at a given relative position.
+ */
+typedef std::function<glm::dvec3(const glm::dvec3&)> Perturbation;
+
+/**
+ * Advances the relative motion of a two-body system using the Kustaanheimo-Stiefel regularization.
+ *
+ * The relative position is mapped to a 4D vector u with |u|² = r and the physical time t to a fictitious time τ with dt = r dτ.
+ * In these variables the unperturbed Kepler motion becomes a harmonic oscillator free of any singularity,
+ * so that close approaches are integrated with the same number of steps as the rest of the orbit, without softening.
+ * See <a href="https://doi.org/10.1515/crll.1965.218.204">Kustaanheimo & Stiefel 1965</a>.
+ *
+ * The regularized equations are integrated with the Runge-Kutta 4 method, using a fixed number of steps per orbit.
+ *
+ * @param position The position of body 2 relative to body 1, updated.
+ * @param speed The speed of body 2 relative to body 1, updated.
+ * @param mu The gravitational parameter G * (mass1 + mass2).
+ * @param duration The physical time to advance.
+ * @param perturbation The perturbing acceleration.
+ */
+void advanceRegularized(glm::dvec3& position, glm::dvec3& speed, double mu, double duration, const Perturbation& perturbation);
+
+#endif //NIHILO_REGULARIZATION_HPP
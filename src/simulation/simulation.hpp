@@ -25,25 +25,53 @@
 
 #include <vector>
 #include "glm/glm.hpp"
+#include "../box.hpp"
 
 constexpr double POSITION_SCALE = 149597870700.0; // Astronomical Unit
 
-struct ParticleSnapshot {
-    glm::vec3 position;
+/**
+ * Per particle data that only changes when particles are added or removed.
+ */
+struct ParticleAttributes {
     float radius;
     glm::vec3 color;
 };
 
+/**
+ * Group of particles contiguous in a snapshot.
+ */
+struct SnapshotCell {
+    Box3 bounds; // including the radius of the particles
+    unsigned int begin, count;
+};
+
 /**
  * Shared data between simulation and render threads.
+ * Positions change every tick while attributes only change with the generation.
  */
 struct SimulationSnapshot {
-    std::vector<ParticleSnapshot> particles;
+    unsigned long long generation; // generation of the layout whose attributes are in this snapshot
+    long long timestamp; // steady clock nanoseconds when the snapshot was published
+    unsigned long long age; // simulation tick of the positions
+    std::vector<glm::vec3> positions; // empty when positions are mapped
+    std::vector<ParticleAttributes> attributes;
+    std::vector<unsigned int> order; // index of each particle in the simulation, written with the attributes
+    unsigned long long particleGeneration; // indices in the simulation only designate the same particles within a generation
+
+    // particles are ordered by cell, followed by one impostor per cell standing for all its particles from afar
+    std::vector<SnapshotCell> cells;
+
+    // optional GPU-mapped storage owned by the renderer, positions are written there directly when they fit
+    glm::vec3* mapping;
+    unsigned long long mappingCapacity; // in positions
+    unsigned int mappingSlot;
+    bool mapped; // whether the positions of this snapshot are in the mapping
 };
 
 struct ParticleInfo {
     double mass;
-    float radius;
+    double physicalRadius; // in meters
+    float radius; // in render unit
     glm::vec3 color;
 };
 
@@ -57,9 +85,16 @@ struct Particle : ParticleInfo {
     ParticleState state[2];
 };
 
+/**
+ * Maps a physical radius in meters to a render radius, the mapping belongs to the preset that created the particles.
+ */
+typedef float (*RadiusScale)(double physicalRadius);
+
 struct Simulation {
     unsigned long long age;
+    unsigned long long generation; // incremented when particles are added, removed or change appearance
     std::vector<Particle> particles;
+    RadiusScale radiusScale;
 };
 
 #endif //NIHILO_SIMULATION_HPP
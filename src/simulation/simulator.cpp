@@ -27,12 +27,28 @@
 #include "motion.hpp"
 #include "preset.hpp"
 
-Simulator::Simulator() : _reset(true) {
-    std::vector<Particle>& particles = _simulation.particles;
-    particles.reserve(SOLAR_SYSTEM_SIZE);
-    for (const ParticleInfo& particle : SOLAR_SYSTEM_INFO) {
-        particles.push_back(Particle(particle));
-    }
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+constexpr double TIME_STEP = 3600.0 * 24; // seconds
+constexpr double SOFTENING_SQ = 1.0;
+
+// interactions start moving from the near to the far field at this fraction of the split radius
+constexpr double SPLIT_INNER_RATIO = 0.8;
+// neighbor lists of the near field are built with this fraction of the split radius as skin
+constexpr double SPLIT_SKIN_RATIO = 0.2;
+
+constexpr double DEFAULT_SPLIT_RADIUS = 0.5 * POSITION_SCALE;
+
+// subsystems are detected again every this number of steps
+constexpr unsigned long long HIERARCHY_PERIOD = 16;
+
+Simulator::Simulator() :
+_reset(true), _collisionMode(CollisionMode::MERGE),
+_integrator(Integrator::VERLET), _substeps(4), _splitRadius(DEFAULT_SPLIT_RADIUS), _potentialsChanged(false), _hierarchical(false), _regularized(false),
+_simulation(), _neighbors(DEFAULT_SPLIT_RADIUS, DEFAULT_SPLIT_RADIUS * SPLIT_SKIN_RATIO), _hierarchyValid(false), _splitValid(false), _layout(0) {
+    _simulation.particles.reserve(SOLAR_SYSTEM_SIZE);
 }
 
 void Simulator::reset() {
@@ -40,38 +56,341 @@ void Simulator::reset() {
 }
 
 void Simulator::update() {
+    if (_potentialsChanged.exchange(false)) {
+        const std::lock_guard lock(_potentialsMutex);
+        _potentials = _pendingPotentials;
+        _splitValid = false;
+    }
+
     if (_reset.exchange(false)) {
         _simulation.age = 0;
+        _simulation.generation++;
+        _simulation.radiusScale = scaleSolarSystemBody;
 
+        // particles may have been merged, the whole list is rebuilt
         std::vector<Particle>& particles = _simulation.particles;
+        particles.clear();
         for (int i = 0; i < SOLAR_SYSTEM_SIZE; i++) {
-            particles[i].state[0] = SOLAR_SYSTEM_INITIAL_STATE[i];
+            Particle particle(SOLAR_SYSTEM_INFO[i]);
+            particle.state[0] = SOLAR_SYSTEM_INITIAL_STATE[i];
+            particles.push_back(particle);
         }
+
+        _hierarchy.clear();
+        _hierarchyValid = false;
+        _splitValid = false;
     } else {
+        std::vector<Particle>& particles = _simulation.particles;
         const auto previousIndex = _simulation.age % 2;
+
+        if (_hierarchical) {
+            if (!_hierarchyValid || _simulation.age % HIERARCHY_PERIOD == 0) {
+                if (_hierarchy.detect(particles, previousIndex, TIME_STEP)) {
+                    _splitValid = false;
+                }
+                _hierarchyValid = true;
+            }
+        } else if (!_hierarchy.isEmpty()) {
+            _hierarchy.clear();
+            _splitValid = false;
+        }
+
         _simulation.age++;
         const auto nextIndex = _simulation.age % 2;
 
-        for (std::vector<Particle>& particles = _simulation.particles; Particle& p1 : particles) {
-            applyVerlet(p1.state[previousIndex], p1.state[nextIndex], 3600.0 * 24, [p1, particles, previousIndex](const ParticleState& state1) {
-                glm::dvec3 force(0);
-                for (const Particle& p2 : particles) {
-                    const ParticleState& state2 = p2.state[previousIndex];
-                    force += gravity(p1.mass, p2.mass, state1.position, state2.position, 1.0);
-                }
-                return classicAcceleration(force, p1.mass);
-            });
+        // subsystems are seen as a single particle by the outer integration
+        std::vector<Particle>& system = _hierarchy.isEmpty() ? particles : _outer;
+        if (!_hierarchy.isEmpty()) {
+            _hierarchy.collapse(particles, previousIndex, _outer);
+        }
+
+        switch (_integrator) {
+            case Integrator::EULER:
+                integrate(applyEuler, system, previousIndex, nextIndex);
+                break;
+            case Integrator::VERLET:
+                integrate(applyVerlet, system, previousIndex, nextIndex);
+                break;
+            case Integrator::MULTI_RATE:
+                integrateMultiRate(system, previousIndex, nextIndex);
+                break;
+        }
+
+        if (!_hierarchy.isEmpty()) {
+            _hierarchy.expand(particles, previousIndex, nextIndex, _outer, TIME_STEP, SOFTENING_SQ, _potentials, _regularized);
+        }
+
+        if (const CollisionMode mode = _collisionMode; mode != CollisionMode::NONE) {
+            if (_collider.detect(particles, nextIndex) != 0 && mode == CollisionMode::MERGE) {
+                _collider.merge(particles, nextIndex, _simulation.radiusScale);
+                _simulation.generation++;
+                _hierarchy.clear();
+                _hierarchyValid = false;
+                _splitValid = false;
+            }
+        }
+    }
+
+    if (_index.update(_simulation.particles, _simulation.age % 2, _simulation.generation)) {
+        _layout++;
+    }
+}
+
+void Simulator::integrate(const Integration integration, std::vector<Particle>& particles, const size_t previousIndex, const size_t nextIndex) {
+    _splitValid = false;
+
+    for (Particle& p1 : particles) {
+        integration(p1.state[previousIndex], p1.state[nextIndex], TIME_STEP, [this, &p1, &particles, previousIndex](const ParticleState& state1) {
+            glm::dvec3 force = potentialAcceleration(_potentials, state1.position) * p1.mass;
+            for (const Particle& p2 : particles) {
+                const ParticleState& state2 = p2.state[previousIndex];
+                force += gravity(p1.mass, p2.mass, state1.position, state2.position, SOFTENING_SQ);
+            }
+            return classicAcceleration(force, p1.mass);
+        });
+    }
+}
+
+void Simulator::integrateMultiRate(std::vector<Particle>& particles, const size_t previousIndex, const size_t nextIndex) {
+    const size_t count = particles.size();
+
+    _positions.resize(count);
+    _speeds.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        const ParticleState& state = particles[i].state[previousIndex];
+        _positions[i] = state.position;
+        _speeds[i] = state.speed;
+    }
+
+    if (const double splitRadius = _splitRadius; splitRadius != _neighbors.getCutoff()) {
+        _neighbors.setCutoff(splitRadius);
+        _neighbors.setSkin(splitRadius * SPLIT_SKIN_RATIO);
+        _splitValid = false;
+    }
+
+    // accelerations of the end of the previous step are reused unless the system changed in between
+    if (!_splitValid) {
+        _nearAccelerations.resize(count);
+        _farAccelerations.resize(count);
+        _neighbors.update(_positions);
+        computeNearAccelerations(particles, _positions, _nearAccelerations);
+        computeFarAccelerations(particles, _positions, _farAccelerations);
+    }
+
+    const unsigned int substeps = _substeps;
+    const double halfStep = TIME_STEP * 0.5;
+    const double substep = TIME_STEP / substeps, halfSubstep = substep * 0.5;
+
+    for (size_t i = 0; i < count; i++) {
+        _speeds[i] += _farAccelerations[i] * halfStep;
+    }
+
+    for (unsigned int s = 0; s < substeps; s++) {
+        for (size_t i = 0; i < count; i++) {
+            _speeds[i] += _nearAccelerations[i] * halfSubstep;
+            _positions[i] += _speeds[i] * substep;
+        }
+
+        _neighbors.update(_positions);
+        computeNearAccelerations(particles, _positions, _nearAccelerations);
+
+        for (size_t i = 0; i < count; i++) {
+            _speeds[i] += _nearAccelerations[i] * halfSubstep;
+        }
+    }
+
+    computeFarAccelerations(particles, _positions, _farAccelerations);
+
+    for (size_t i = 0; i < count; i++) {
+        ParticleState& state = particles[i].state[nextIndex];
+        state.position = _positions[i];
+        state.speed = _speeds[i] + _farAccelerations[i] * halfStep;
+        state.acceleration = _nearAccelerations[i] + _farAccelerations[i];
+    }
+
+    _splitValid = true;
+}
+
+void Simulator::computeNearAccelerations(const std::vector<Particle>& particles, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations) const {
+    const double outer = _neighbors.getCutoff(), inner = outer * SPLIT_INNER_RATIO;
+
+    for (size_t i = 0; i < positions.size(); i++) {
+        const double mass1 = particles[i].mass;
+        const glm::dvec3& position1 = positions[i];
+
+        glm::dvec3 force(0);
+        for (const unsigned int j : _neighbors.get(i)) {
+            const glm::dvec3& position2 = positions[j];
+            if (const double fraction = nearFraction(glm::distance(position1, position2), inner, outer); fraction > 0) {
+                force += gravity(mass1, particles[j].mass, position1, position2, SOFTENING_SQ) * fraction;
+            }
         }
+        accelerations[i] = classicAcceleration(force, mass1);
     }
 }
 
+void Simulator::computeFarAccelerations(const std::vector<Particle>& particles, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations) const {
+    const double outer = _neighbors.getCutoff(), inner = outer * SPLIT_INNER_RATIO;
+
+    for (size_t i = 0; i < positions.size(); i++) {
+        const double mass1 = particles[i].mass;
+        const glm::dvec3& position1 = positions[i];
+
+        glm::dvec3 force(0);
+        for (size_t j = 0; j < positions.size(); j++) {
+            const glm::dvec3& position2 = positions[j];
+            if (const double fraction = 1 - nearFraction(glm::distance(position1, position2), inner, outer); fraction > 0) {
+                force += gravity(mass1, particles[j].mass, position1, position2, SOFTENING_SQ) * fraction;
+            }
+        }
+        accelerations[i] = classicAcceleration(force, mass1);
+    }
+
+    // external potentials are smooth and slowly varying, they belong to the far field
+    addPotentialAccelerations(_potentials, positions, accelerations);
+}
+
 void Simulator::snapshot(SimulationSnapshot& snapshot) const {
-    std::vector<ParticleSnapshot>& particles = snapshot.particles;
-    particles.reserve(_simulation.particles.size());
+    const std::vector<Particle>& particles = _simulation.particles;
+    const std::vector<unsigned int>& order = _index.getOrder();
+    const std::vector<unsigned int>& starts = _index.getCellStarts();
+    const size_t count = particles.size();
+    const size_t cellCount = starts.size() - 1;
+    const size_t total = count + cellCount;
+
+    // snapshots are reused, attributes only need to be written when they changed since this snapshot was filled
+    std::vector<ParticleAttributes>& attributes = snapshot.attributes;
+    if (snapshot.generation != _layout || attributes.size() != total) {
+        attributes.resize(total);
+        for (size_t i = 0; i < count; i++) {
+            attributes[i].radius = particles[order[i]].radius;
+            attributes[i].color = particles[order[i]].color;
+        }
+
+        // impostors keep the total area and the mean color of their cell
+        for (size_t c = 0; c < cellCount; c++) {
+            float area = 0;
+            glm::vec3 color(0);
+            for (unsigned int i = starts[c]; i < starts[c + 1]; i++) {
+                const float weight = attributes[i].radius * attributes[i].radius;
+                area += weight;
+                color += attributes[i].color * weight;
+            }
+            attributes[count + c].radius = std::sqrt(area);
+            attributes[count + c].color = area > 0 ? color / area : attributes[starts[c]].color;
+        }
+        snapshot.order.assign(order.begin(), order.end());
+        snapshot.particleGeneration = _simulation.generation;
+        snapshot.generation = _layout;
+    }
 
+    // positions go straight to GPU memory when the renderer provided a mapping large enough
+    glm::vec3* out;
+    snapshot.mapped = snapshot.mapping && total <= snapshot.mappingCapacity;
+    if (snapshot.mapped) {
+        snapshot.positions.clear();
+        out = snapshot.mapping;
+    } else {
+        snapshot.positions.resize(total);
+        out = snapshot.positions.data();
+    }
+
+    // positions are converted in simulation order, a tight loop over contiguous particles
+    snapshot.age = _simulation.age;
     const auto index = _simulation.age % 2;
-    for (const Particle& particle : _simulation.particles) {
-        ParticleSnapshot p(particle.state[index].position / POSITION_SCALE, particle.radius, particle.color);
-        particles.push_back(p);
+    constexpr double scale = 1.0 / POSITION_SCALE;
+    const Particle* in = particles.data();
+    _converted.resize(count);
+    glm::vec3* converted = _converted.data();
+    for (size_t i = 0; i < count; i++) {
+        const glm::dvec3& position = in[i].state[index].position;
+        glm::vec3& result = converted[i];
+        result.x = static_cast<float>(position.x * scale);
+        result.y = static_cast<float>(position.y * scale);
+        result.z = static_cast<float>(position.z * scale);
     }
+
+    // then permuted cell by cell, bounds and impostors follow the particles since the order is only rebuilt periodically
+    snapshot.cells.resize(cellCount);
+    for (size_t c = 0; c < cellCount; c++) {
+        SnapshotCell& cell = snapshot.cells[c];
+        cell.begin = starts[c];
+        cell.count = starts[c + 1] - starts[c];
+        cell.bounds.min = glm::vec3(std::numeric_limits<float>::max());
+        cell.bounds.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+        float area = 0;
+        glm::vec3 center(0);
+        for (unsigned int i = starts[c]; i < starts[c + 1]; i++) {
+            const glm::vec3& result = converted[order[i]];
+            out[i] = result;
+
+            const float radius = attributes[i].radius;
+            cell.bounds.min = glm::min(cell.bounds.min, result - radius);
+            cell.bounds.max = glm::max(cell.bounds.max, result + radius);
+            area += radius * radius;
+            center += result * (radius * radius);
+        }
+        out[count + c] = area > 0 ? center / area : glm::vec3(cell.bounds.min + cell.bounds.max) * 0.5f;
+    }
+}
+
+CollisionMode Simulator::getCollisionMode() const {
+    return _collisionMode;
+}
+
+void Simulator::setCollisionMode(const CollisionMode mode) {
+    _collisionMode = mode;
+}
+
+Integrator Simulator::getIntegrator() const {
+    return _integrator;
+}
+
+void Simulator::setIntegrator(const Integrator integrator) {
+    _integrator = integrator;
+}
+
+unsigned int Simulator::getSubsteps() const {
+    return _substeps;
+}
+
+void Simulator::setSubsteps(const unsigned int substeps) {
+    if (substeps == 0) {
+        throw std::domain_error("Substeps must be greater than zero");
+    }
+    _substeps = substeps;
+}
+
+double Simulator::getSplitRadius() const {
+    return _splitRadius;
+}
+
+void Simulator::setSplitRadius(const double radius) {
+    if (radius <= 0) {
+        throw std::domain_error("Split radius must be greater than zero");
+    }
+    _splitRadius = radius;
+}
+
+void Simulator::setPotentials(const std::vector<Potential>& potentials) {
+    const std::lock_guard lock(_potentialsMutex);
+    _pendingPotentials = potentials;
+    _potentialsChanged = true;
+}
+
+bool Simulator::isHierarchical() const {
+    return _hierarchical;
+}
+
+void Simulator::setHierarchical(const bool hierarchical) {
+    _hierarchical = hierarchical;
+}
+
+bool Simulator::isRegularized() const {
+    return _regularized;
+}
+
+void Simulator::setRegularized(const bool regularized) {
+    _regularized = regularized;
 }
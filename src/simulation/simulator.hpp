@@ -25,8 +25,15 @@
 
 #include <atomic>
 #include <memory>
+#include <mutex>
 
+#include "collision.hpp"
+#include "index.hpp"
+#include "integration.hpp"
+#include "neighbor.hpp"
+#include "potential.hpp"
 #include "simulation.hpp"
+#include "subsystem.hpp"
 
 class Simulator {
     public:
@@ -39,10 +46,91 @@ class Simulator {
 
     void snapshot(SimulationSnapshot& snapshot) const;
 
+    [[nodiscard]] CollisionMode getCollisionMode() const;
+
+    void setCollisionMode(CollisionMode mode);
+
+    [[nodiscard]] Integrator getIntegrator() const;
+
+    void setIntegrator(Integrator integrator);
+
+    [[nodiscard]] unsigned int getSubsteps() const;
+
+    /**
+     * Sets the number of near field substeps per step of the multi-rate integrator.
+     * The far field is evaluated once per step, so this is the ratio between near and far evaluations.
+     *
+     * @param substeps The number of substeps, at least 1.
+     */
+    void setSubsteps(unsigned int substeps);
+
+    [[nodiscard]] double getSplitRadius() const;
+
+    /**
+     * Sets the distance above which interactions are fully handled by the far field of the multi-rate integrator.
+     *
+     * @param radius The radius in meters.
+     */
+    void setSplitRadius(double radius);
+
+    /**
+     * Replaces the external potentials applied to every particle in addition to their mutual gravity.
+     * The change is applied at the beginning of the next update.
+     *
+     * @param potentials The potentials.
+     */
+    void setPotentials(const std::vector<Potential>& potentials);
+
+    [[nodiscard]] bool isHierarchical() const;
+
+    /**
+     * Enables or disables the detection of bound subsystems, integrated separately with their own substeps.
+     * Disabled by default, the heaviest particle has no Hill sphere and hosts every fast enough orbit, planets included.
+     *
+     * @param hierarchical Whether subsystems are detected.
+     */
+    void setHierarchical(bool hierarchical);
+
+    [[nodiscard]] bool isRegularized() const;
+
+    /**
+     * Enables or disables the Kustaanheimo-Stiefel regularization of bound pairs detected as subsystems.
+     * Without it, pairs are integrated with substeps like any other subsystem. Disabled by default.
+     *
+     * @param regularized Whether pairs are regularized.
+     */
+    void setRegularized(bool regularized);
+
     private:
 
+    void integrate(Integration integration, std::vector<Particle>& particles, size_t previousIndex, size_t nextIndex);
+
+    void integrateMultiRate(std::vector<Particle>& particles, size_t previousIndex, size_t nextIndex);
+
+    void computeNearAccelerations(const std::vector<Particle>& particles, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations) const;
+
+    void computeFarAccelerations(const std::vector<Particle>& particles, const std::vector<glm::dvec3>& positions, std::vector<glm::dvec3>& accelerations) const;
+
     std::atomic<bool> _reset;
+    std::atomic<CollisionMode> _collisionMode;
+    std::atomic<Integrator> _integrator;
+    std::atomic<unsigned int> _substeps;
+    std::atomic<double> _splitRadius;
+    std::atomic<bool> _potentialsChanged;
+    std::atomic<bool> _hierarchical, _regularized;
+    std::mutex _potentialsMutex;
+    std::vector<Potential> _potentials, _pendingPotentials;
     Simulation _simulation;
+    Collider _collider;
+    NeighborList _neighbors;
+    Hierarchy _hierarchy;
+    std::vector<Particle> _outer;
+    bool _hierarchyValid;
+    std::vector<glm::dvec3> _positions, _speeds, _nearAccelerations, _farAccelerations;
+    bool _splitValid;
+    CellIndex _index;
+    unsigned long long _layout; // incremented when the snapshot order or attributes change
+    mutable std::vector<glm::vec3> _converted; // positions of the last snapshot in simulation order
 };
 
 #endif //NIHILO_SIMULATOR_HPP
\ No newline at end of file
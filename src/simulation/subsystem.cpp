@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "subsystem.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "force.hpp"
+#include "regularization.hpp"
+#include "glm/gtc/constants.hpp"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/gtx/norm.hpp"
+
+// satellites must lie within this fraction of the Hill sphere of their host
+constexpr double HILL_FRACTION = 0.5;
+// number of steps needed to accurately integrate an orbit
+constexpr double STEPS_PER_ORBIT = 128;
+constexpr unsigned int MAX_SUBSTEPS = 1024;
+
+inline bool isHeavier(const std::vector<Particle>& particles, const unsigned int a, const unsigned int b) {
+    return particles[a].mass > particles[b].mass || (particles[a].mass == particles[b].mass && a < b);
+}
+
+/**
+ * Computes the gravitational acceleration of the outer particles, except the subsystem itself, at the given position.
+ */
+inline glm::dvec3 externalAcceleration(const glm::dvec3& position, const std::vector<Particle>& outer, const unsigned int outerSelf, const size_t index,
+                                       const double softSq, const std::vector<Potential>& potentials) {
+    glm::dvec3 acceleration = potentialAcceleration(potentials, position);
+    for (unsigned int o = 0; o < outer.size(); o++) {
+        if (o != outerSelf) {
+            acceleration += gravity(1, outer[o].mass, position, outer[o].state[index].position, softSq);
+        }
+    }
+    return acceleration;
+}
+
+bool Hierarchy::detect(const std::vector<Particle>& particles, const size_t index, const double timeStep) {
+    const auto count = static_cast<unsigned int>(particles.size());
+    _primaries.assign(count, -1);
+    _hosts.assign(count, -1);
+    _periods.assign(count, 0);
+
+    // the primary of a particle is the heavier particle pulling it the most
+    for (unsigned int i = 0; i < count; i++) {
+        const glm::dvec3& position = particles[i].state[index].position;
+        double maxPull = 0;
+        for (unsigned int j = 0; j < count; j++) {
+            if (j == i || !isHeavier(particles, j, i)) {
+                continue;
+            }
+            if (const double pull = particles[j].mass / glm::distance2(position, particles[j].state[index].position); pull > maxPull) {
+                maxPull = pull;
+                _primaries[i] = static_cast<int>(j);
+            }
+        }
+    }
+
+    // the host of a particle is the closest heavier particle it orbits within its Hill sphere
+    const double maxPeriod = STEPS_PER_ORBIT * timeStep;
+    for (unsigned int i = 0; i < count; i++) {
+        const ParticleState& state = particles[i].state[index];
+        double minDistance2 = std::numeric_limits<double>::infinity();
+        for (unsigned int j = 0; j < count; j++) {
+            if (j == i || !isHeavier(particles, j, i)) {
+                continue;
+            }
+
+            const ParticleState& hostState = particles[j].state[index];
+            const double distance2 = glm::distance2(state.position, hostState.position);
+            if (distance2 >= minDistance2) {
+                continue;
+            }
+
+            // a host without primary dominates the whole system, only the period limits its satellites
+            if (const int primary = _primaries[j]; primary >= 0) {
+                const double hill = glm::distance(hostState.position, particles[primary].state[index].position)
+                                    * std::cbrt(particles[j].mass / (3 * particles[primary].mass)) * HILL_FRACTION;
+                if (distance2 > hill * hill) {
+                    continue;
+                }
+            }
+
+            // semi-major axis from the vis-viva equation, negative when unbound
+            const double mu = G * (particles[i].mass + particles[j].mass);
+            const double inverseAxis = 2 / std::sqrt(distance2) - glm::distance2(state.speed, hostState.speed) / mu;
+            if (inverseAxis <= 0) {
+                continue;
+            }
+            const double axis = 1 / inverseAxis;
+            const double period = glm::two_pi<double>() * std::sqrt(axis * axis * axis / mu);
+            if (period >= maxPeriod) {
+                continue;
+            }
+
+            minDistance2 = distance2;
+            _hosts[i] = static_cast<int>(j);
+            _periods[i] = period;
+        }
+    }
+
+    // hosts are strictly heavier, so following them always ends on a root
+    _roots.resize(count);
+    for (unsigned int i = 0; i < count; i++) {
+        unsigned int root = i;
+        while (_hosts[root] >= 0) {
+            root = _hosts[root];
+        }
+        _roots[i] = root;
+    }
+
+    std::vector<Subsystem> subsystems;
+    std::vector<unsigned int> members;
+    for (unsigned int root = 0; root < count; root++) {
+        if (_hosts[root] >= 0) {
+            continue;
+        }
+
+        Subsystem subsystem{root, static_cast<unsigned int>(members.size()), 0, 1};
+        members.push_back(root);
+        for (unsigned int i = 0; i < count; i++) {
+            if (i != root && _roots[i] == root) {
+                members.push_back(i);
+                const double substeps = std::ceil(maxPeriod / _periods[i]);
+                subsystem.substeps = std::max(subsystem.substeps, std::min(static_cast<unsigned int>(substeps), MAX_SUBSTEPS));
+            }
+        }
+        subsystem.end = static_cast<unsigned int>(members.size());
+
+        if (subsystem.end - subsystem.begin > 1) {
+            subsystems.push_back(subsystem);
+        } else {
+            members.pop_back();
+        }
+    }
+
+    bool changed = members != _members || subsystems.size() != _subsystems.size();
+    for (size_t s = 0; !changed && s < subsystems.size(); s++) {
+        changed = subsystems[s].root != _subsystems[s].root || subsystems[s].end != _subsystems[s].end;
+    }
+
+    _subsystems = std::move(subsystems);
+    _members = std::move(members);
+    return changed;
+}
+
+void Hierarchy::clear() {
+    _subsystems.clear();
+    _members.clear();
+}
+
+bool Hierarchy::isEmpty() const {
+    return _subsystems.empty();
+}
+
+const std::vector<Subsystem>& Hierarchy::getSubsystems() const {
+    return _subsystems;
+}
+
+void Hierarchy::collapse(const std::vector<Particle>& particles, const size_t index, std::vector<Particle>& outer) {
+    const auto count = static_cast<unsigned int>(particles.size());
+    _owners.assign(count, -1);
+    for (int s = 0; s < static_cast<int>(_subsystems.size()); s++) {
+        for (unsigned int k = _subsystems[s].begin; k < _subsystems[s].end; k++) {
+            _owners[_members[k]] = s;
+        }
+    }
+
+    outer.clear();
+    _outerIndices.resize(count);
+    _subsystemOuters.assign(_subsystems.size(), -1);
+
+    for (unsigned int i = 0; i < count; i++) {
+        const int owner = _owners[i];
+        if (owner < 0) {
+            _outerIndices[i] = static_cast<unsigned int>(outer.size());
+            outer.push_back(particles[i]);
+            continue;
+        }
+
+        if (_subsystemOuters[owner] < 0) {
+            const Subsystem& subsystem = _subsystems[owner];
+            _subsystemOuters[owner] = static_cast<int>(outer.size());
+
+            // the root gives its appearance to the whole subsystem
+            Particle composite = particles[subsystem.root];
+            ParticleState& center = composite.state[index];
+            center = {glm::dvec3(0), glm::dvec3(0), glm::dvec3(0)};
+            composite.mass = 0;
+
+            for (unsigned int k = subsystem.begin; k < subsystem.end; k++) {
+                const Particle& member = particles[_members[k]];
+                const ParticleState& state = member.state[index];
+                center.position += state.position * member.mass;
+                center.speed += state.speed * member.mass;
+                center.acceleration += state.acceleration * member.mass;
+                composite.mass += member.mass;
+            }
+
+            center.position /= composite.mass;
+            center.speed /= composite.mass;
+            center.acceleration /= composite.mass;
+            outer.push_back(composite);
+        }
+        _outerIndices[i] = static_cast<unsigned int>(_subsystemOuters[owner]);
+    }
+}
+
+void Hierarchy::expand(std::vector<Particle>& particles, const size_t previousIndex, const size_t nextIndex, const std::vector<Particle>& outer,
+                       const double timeStep, const double softSq, const std::vector<Potential>& potentials, const bool regularized) {
+    for (unsigned int i = 0; i < particles.size(); i++) {
+        if (_owners[i] < 0) {
+            particles[i].state[nextIndex] = outer[_outerIndices[i]].state[nextIndex];
+        }
+    }
+
+    for (size_t s = 0; s < _subsystems.size(); s++) {
+        const Subsystem& subsystem = _subsystems[s];
+        if (regularized && subsystem.end - subsystem.begin == 2) {
+            integratePair(subsystem, particles, previousIndex, nextIndex, outer, _subsystemOuters[s], timeStep, softSq, potentials);
+        } else {
+            integrate(subsystem, particles, previousIndex, nextIndex, outer, _subsystemOuters[s], timeStep, softSq, potentials);
+        }
+    }
+}
+
+void Hierarchy::integratePair(const Subsystem& subsystem, std::vector<Particle>& particles, const size_t previousIndex, const size_t nextIndex,
+                              const std::vector<Particle>& outer, const unsigned int outerSelf, const double timeStep, const double softSq, const std::vector<Potential>& potentials) {
+    const ParticleState& previousCenter = outer[outerSelf].state[previousIndex];
+    const ParticleState& nextCenter = outer[outerSelf].state[nextIndex];
+
+    Particle& particle1 = particles[_members[subsystem.begin]];
+    Particle& particle2 = particles[_members[subsystem.begin + 1]];
+    const double mass = particle1.mass + particle2.mass;
+    const double weight1 = particle2.mass / mass, weight2 = particle1.mass / mass;
+
+    glm::dvec3 position = particle2.state[previousIndex].position - particle1.state[previousIndex].position;
+    glm::dvec3 speed = particle2.state[previousIndex].speed - particle1.state[previousIndex].speed;
+
+    // the rest of the system is frozen during the step, its tidal acceleration perturbs the pair
+    advanceRegularized(position, speed, G * mass, timeStep, [&](const glm::dvec3& relative) {
+        const glm::dvec3 acceleration1 = externalAcceleration(previousCenter.position - relative * weight1, outer, outerSelf, previousIndex, softSq, potentials);
+        const glm::dvec3 acceleration2 = externalAcceleration(previousCenter.position + relative * weight2, outer, outerSelf, previousIndex, softSq, potentials);
+        return acceleration2 - acceleration1;
+    });
+
+    const glm::dvec3 acceleration = position * (G / std::pow(glm::length2(position), 1.5));
+
+    ParticleState& state1 = particle1.state[nextIndex];
+    state1.position = nextCenter.position - position * weight1;
+    state1.speed = nextCenter.speed - speed * weight1;
+    state1.acceleration = nextCenter.acceleration + acceleration * particle2.mass;
+
+    ParticleState& state2 = particle2.state[nextIndex];
+    state2.position = nextCenter.position + position * weight2;
+    state2.speed = nextCenter.speed + speed * weight2;
+    state2.acceleration = nextCenter.acceleration - acceleration * particle1.mass;
+}
+
+void Hierarchy::integrate(const Subsystem& subsystem, std::vector<Particle>& particles, const size_t previousIndex, const size_t nextIndex,
+                          const std::vector<Particle>& outer, const unsigned int outerSelf, const double timeStep, const double softSq, const std::vector<Potential>& potentials) {
+    const ParticleState& previousCenter = outer[outerSelf].state[previousIndex];
+    const ParticleState& nextCenter = outer[outerSelf].state[nextIndex];
+    const unsigned int count = subsystem.end - subsystem.begin;
+
+    // internal motion, relative to the center of mass
+    _positions.resize(count);
+    _speeds.resize(count);
+    _accelerations.resize(count);
+    for (unsigned int k = 0; k < count; k++) {
+        const ParticleState& state = particles[_members[subsystem.begin + k]].state[previousIndex];
+        _positions[k] = state.position - previousCenter.position;
+        _speeds[k] = state.speed - previousCenter.speed;
+    }
+
+    // the rest of the system is frozen during the substeps
+    const glm::dvec3 tidalOrigin = externalAcceleration(previousCenter.position, outer, outerSelf, previousIndex, softSq, potentials);
+    computeAccelerations(subsystem, particles, previousCenter.position, tidalOrigin, outer, outerSelf, previousIndex, softSq, potentials);
+
+    const double substep = timeStep / subsystem.substeps, halfSubstep = substep * 0.5;
+    for (unsigned int s = 0; s < subsystem.substeps; s++) {
+        for (unsigned int k = 0; k < count; k++) {
+            _speeds[k] += _accelerations[k] * halfSubstep;
+            _positions[k] += _speeds[k] * substep;
+        }
+
+        computeAccelerations(subsystem, particles, previousCenter.position, tidalOrigin, outer, outerSelf, previousIndex, softSq, potentials);
+
+        for (unsigned int k = 0; k < count; k++) {
+            _speeds[k] += _accelerations[k] * halfSubstep;
+        }
+    }
+
+    // tidal accelerations do not cancel out, the center of mass is kept where the outer integration put it
+    glm::dvec3 positionDrift(0), speedDrift(0);
+    double mass = 0;
+    for (unsigned int k = 0; k < count; k++) {
+        const double m = particles[_members[subsystem.begin + k]].mass;
+        positionDrift += _positions[k] * m;
+        speedDrift += _speeds[k] * m;
+        mass += m;
+    }
+    positionDrift /= mass;
+    speedDrift /= mass;
+
+    for (unsigned int k = 0; k < count; k++) {
+        ParticleState& state = particles[_members[subsystem.begin + k]].state[nextIndex];
+        state.position = nextCenter.position + _positions[k] - positionDrift;
+        state.speed = nextCenter.speed + _speeds[k] - speedDrift;
+        state.acceleration = nextCenter.acceleration + _accelerations[k];
+    }
+}
+
+void Hierarchy::computeAccelerations(const Subsystem& subsystem, const std::vector<Particle>& particles, const glm::dvec3& center, const glm::dvec3& tidalOrigin,
+                                     const std::vector<Particle>& outer, const unsigned int outerSelf, const size_t outerIndex, const double softSq, const std::vector<Potential>& potentials) {
+    const unsigned int count = subsystem.end - subsystem.begin;
+    for (unsigned int k = 0; k < count; k++) {
+        glm::dvec3 acceleration = externalAcceleration(center + _positions[k], outer, outerSelf, outerIndex, softSq, potentials) - tidalOrigin;
+        for (unsigned int l = 0; l < count; l++) {
+            acceleration += gravity(1, particles[_members[subsystem.begin + l]].mass, _positions[k], _positions[l], softSq);
+        }
+        _accelerations[k] = acceleration;
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025 Hugo Dupanloup (Yeregorix)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NIHILO_SUBSYSTEM_HPP
+#define NIHILO_SUBSYSTEM_HPP
+
+#include <vector>
+
+#include "potential.hpp"
+#include "simulation.hpp"
+
+struct Subsystem {
+    unsigned int root; // index of the most massive particle of the subsystem
+    unsigned int begin, end; // range of the members in the member list
+    unsigned int substeps;
+};
+
+/**
+ * Detects bound subsystems (moons around a planet, binaries, ...) and integrates them separately from the rest of the system.
+ *
+ * A particle is a satellite of the closest heavier particle it is bound to and lying within its Hill sphere,
+ * provided its orbital period is too short to be integrated accurately with the outer time step.
+ * A subsystem gathers a root particle and all its satellites, recursively.
+ *
+ * The outer integration sees each subsystem as a single particle located at its center of mass.
+ * The internal motion is integrated in the frame of the center of mass with its own substeps,
+ * under the mutual gravity of the members and the tidal acceleration of the rest of the system.
+ * Pairs can instead be integrated with the Kustaanheimo-Stiefel regularization, which is exact at close approaches.
+ */
+class Hierarchy {
+    public:
+
+    /**
+     * Detects the subsystems of the given particles.
+     *
+     * @param particles The particles.
+     * @param index The index of the state to analyse.
+     * @param timeStep The time step of the outer integration.
+     * @return Whether the subsystems changed.
+     */
+    bool detect(const std::vector<Particle>& particles, size_t index, double timeStep);
+
+    /**
+     * Forgets the subsystems, for instance because particles were added or removed.
+     */
+    void clear();
+
+    [[nodiscard]] bool isEmpty() const;
+
+    [[nodiscard]] const std::vector<Subsystem>& getSubsystems() const;
+
+    /**
+     * Builds the list of particles seen by the outer integration, where each subsystem is replaced by its center of mass.
+     *
+     * @param particles The particles.
+     * @param index The index of the state to collapse.
+     * @param outer The outer particles, overwritten.
+     */
+    void collapse(const std::vector<Particle>& particles, size_t index, std::vector<Particle>& outer);
+
+    /**
+     * Copies the motion computed by the outer integration back to the particles
+     * and integrates the internal motion of every subsystem.
+     *
+     * @param particles The particles.
+     * @param previousIndex The index of the current state.
+     * @param nextIndex The index of the state to compute.
+     * @param outer The outer particles, integrated from previous to next state.
+     * @param timeStep The time step of the outer integration.
+     * @param softSq Squared value of the softening parameter.
+     * @param potentials External potentials, contributing to the tidal acceleration.
+     * @param regularized Whether pairs are integrated using the Kustaanheimo-Stiefel regularization.
+     */
+    void expand(std::vector<Particle>& particles, size_t previousIndex, size_t nextIndex, const std::vector<Particle>& outer,
+                double timeStep, double softSq, const std::vector<Potential>& potentials, bool regularized);
+
+    private:
+
+    void integratePair(const Subsystem& subsystem, std::vector<Particle>& particles, size_t previousIndex, size_t nextIndex,
+                       const std::vector<Particle>& outer, unsigned int outerSelf, double timeStep, double softSq, const std::vector<Potential>& potentials);
+
+    void integrate(const Subsystem& subsystem, std::vector<Particle>& particles, size_t previousIndex, size_t nextIndex,
+                   const std::vector<Particle>& outer, unsigned int outerSelf, double timeStep, double softSq, const std::vector<Potential>& potentials);
+
+    void computeAccelerations(const Subsystem& subsystem, const std::vector<Particle>& particles, const glm::dvec3& center, const glm::dvec3& tidalOrigin,
+                              const std::vector<Particle>& outer, unsigned int outerSelf, size_t outerIndex, double softSq, const std::vector<Potential>& potentials);
+
+    std::vector<Subsystem> _subsystems;
+    std::vector<unsigned int> _members, _outerIndices, _roots;
+    std::vector<int> _hosts, _primaries, _owners, _subsystemOuters;
+    std::vector<double> _periods;
+    std::vector<glm::dvec3> _positions, _speeds, _accelerations;
+};
+
+#endif //NIHILO_SUBSYSTEM_HPP